@@ -7,6 +7,7 @@
 #include "chess/Board.hpp"
 #include "chess/Eval.hpp"
 #include "chess/Search.hpp"
+#include "chess/Perft.hpp"
 
 // Convenience namespace alias
 namespace ch = chess;
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+
+#include "Nnue.hpp"
+#include "Search.hpp"
+#include "types.hpp"
+
+namespace chess {
+
+    /// One position to analyze. A job that sets either budget searches with its
+    /// own only (depth 0 then means as deep as the node limit allows); one that
+    /// sets neither uses BatchConfig's
+    struct BatchJob {
+        std::string fen;
+        std::string id;         // EPD `id`, passed through to the result
+        Depth depth = 0;
+        uint64_t nodes = 0;
+    };
+
+    struct BatchResult {
+        size_t index;           // The job's place in the input (EPD lines not counting blanks and comments)
+        BatchJob job;
+        SearchResult result;    // Left empty when error is set
+        std::string error;      // Unparsable line or FEN
+    };
+
+    struct BatchConfig {
+        int workers = 0;            // Threads, each searching with its own Engine; 0 = one per hardware thread
+        SearchConfig search;        // Every engine's settings; search.threads is best left at 1
+        std::shared_ptr<const NnueNetwork> network;
+        Depth depth = 8;            // Budget for jobs that don't set one
+        uint64_t nodes = 0;
+        bool share_tt = false;      // One table of search.tt_size_mb for all engines instead of one each
+        size_t max_pending = 0;     // Jobs accepted but not yet reported; 0 = four per worker
+    };
+
+    /// Analyzes large sets of positions on a pool of reusable engines.
+    ///
+    /// The calling thread feeds jobs to per-worker queues round robin; a worker
+    /// that runs dry steals from the back of another's queue, so long searches
+    /// never leave threads idle behind them. At most max_pending jobs are in the
+    /// pool at once and the feeder waits for results before reading further, so
+    /// a stream of any length runs in constant memory.
+    ///
+    /// Results arrive through the callback in completion order, one at a time
+    /// (never concurrently) but on the worker threads. Engines, and their tables,
+    /// persist across jobs and runs: results can depend on what was searched
+    /// before, as they do in a game.
+    class BatchAnalyzer {
+    public:
+        using Callback = std::function<void(const BatchResult&)>;
+
+        explicit BatchAnalyzer(const BatchConfig& config);
+        ~BatchAnalyzer();
+
+        BatchAnalyzer(const BatchAnalyzer&) = delete;
+        BatchAnalyzer& operator=(const BatchAnalyzer&) = delete;
+
+        /// Analyze every job and return once all results have been delivered;
+        /// the number delivered. An exception thrown by the callback cancels
+        /// the jobs not yet started and is rethrown here
+        size_t run(std::span<const BatchJob> jobs, const Callback& on_result);
+
+        /// Same for EPD or FEN lines read from the stream as they're needed
+        size_t run(std::istream& input, const Callback& on_result);
+
+        /// One EPD record (four FEN fields and `;`-terminated operations, of
+        /// which acd, acn, id, hmvc and fmvn are used) or a full FEN line.
+        /// Nothing for blank and `#` comment lines
+        /// @throws std::invalid_argument on too few fields or a bad acd/acn/hmvc/fmvn operand
+        [[nodiscard]] static std::optional<BatchJob> parse_line(const std::string& line);
+
+        [[nodiscard]] int worker_count() const;
+
+    private:
+        class Impl;
+        std::unique_ptr<Impl> impl;
+    };
+
+}  // namespace chess
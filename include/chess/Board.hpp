@@ -9,6 +9,9 @@
 
 namespace chess {
 
+    class NnueNetwork;
+    namespace nnue { struct Accumulator; }
+
     class Board {
 public:
     Board();
@@ -16,12 +19,16 @@ public:
     Board(const Board& board);
     Board& operator=(const Board& other);
 
+    /// Board at a snapshot taken with position(); the move history starts empty
+    explicit Board(const Position& position);
+
     // === Initialization ===
 
-    /// Load position from FEN string
+    /// Load position from FEN string, parsed in place. The two clocks may be
+    /// left off, as in EPD, and then read as 0 and 1
     /// @param fen Forsyth-Edwards Notation string
     /// @throws std::invalid_argument if FEN is malformed
-    void load_fen(const std::string& fen) const;
+    void load_fen(std::string_view fen) const;
 
     /// Get current position as FEN
     /// @return FEN string representation
@@ -30,9 +37,12 @@ public:
     /// Reset to standard starting position
     void reset() const;
 
+    /// Replace the position with a snapshot and clear the history (no allocation)
+    void set_position(const Position& position) const;
+
     // === Board Queries ===
 
-    /// Get piece at square
+    /// Get piece at square (constant-time mailbox lookup)
     [[nodiscard]] Piece piece_at(Square sq) const;
 
     /// Get all pieces of type for color
@@ -41,6 +51,13 @@ public:
     /// Get all pieces for a color
     [[nodiscard]] std::vector<Square> pieces_of_color(Color color) const;
 
+    /// Bitboard of all pieces of type for color (no allocation)
+    /// Iterate with `for (const Square sq : Squares(board.pieces(color, type)))`
+    [[nodiscard]] Bitboard pieces(Color color, PieceType type) const;
+
+    /// Bitboard of all pieces for a color (no allocation)
+    [[nodiscard]] Bitboard occupancy(Color color) const;
+
     /// Whose turn is it?
     [[nodiscard]] Color side_to_move() const;
 
@@ -65,20 +82,63 @@ public:
     /// @param moves MoveList to fill with legal moves
     void generate_moves(MoveList& moves) const;
 
-    /// Generate only capture moves
+    /// Generate legal captures, en passant and queen promotions
+    /// @param moves MoveList to fill with tactical moves
     void generate_captures(MoveList& moves) const;
 
+    /// Generate legal non-tactical moves (the complement of generate_captures)
+    /// @param moves MoveList to fill with quiet moves, castling and under-promotions
+    void generate_quiets(MoveList& moves) const;
+
     /// Check if a move is legal
     [[nodiscard]] bool is_legal_move(Move move) const;
 
+    /// Is this exactly a move generate_moves() would produce here?
+    /// Runs only the moving piece's generator, so it is cheap enough to vet hash and killer moves
+    [[nodiscard]] bool is_generated_move(Move move) const;
+
+    /// Static exchange evaluation: material won (centipawns, PIECE_VALUES) by the
+    /// move's side if both sides keep recapturing on the target square with their
+    /// least valuable piece, each free to stop. Sliders behind capturers join in (x-rays);
+    /// pins are ignored.
+    [[nodiscard]] int see(Move move) const;
+
+    /// Does see(move) reach threshold? Stops as soon as the answer is known
+    [[nodiscard]] bool see_ge(Move move, int threshold) const;
+
+    /// The legal move written in Standard Algebraic Notation (Nf3, exd6, O-O,
+    /// e8=Q+, ...); check and annotation marks are ignored
+    /// @throws std::invalid_argument if no legal move matches, or more than one does
+    [[nodiscard]] Move parse_san(std::string_view san) const;
+
     /// Make a move (modifies board state)
     /// @throws std::invalid_argument if move is illegal
+    /// @throws std::length_error if the history already holds MAX_GAME_PLIES moves
+    /// (clear_history() to play on); the rest is kept free for the search
     void make_move(Move move) const;
 
     /// Undo the last move
     /// @throws std::runtime_error if no moves to undo
     void undo_move() const;
 
+    /// Make a move without validating it (search fast path)
+    /// The move must come from generate_moves/captures/quiets for this position.
+    void make_move_unchecked(Move move) const;
+
+    /// Undo the last move without checking that there is one
+    void undo_move_unchecked() const;
+
+    /// Copy-make undo: drop the last history entry and restore the snapshot
+    /// taken with position() just before that move was made
+    void undo_move_to(const Position& snapshot) const;
+
+    /// Pass the turn: flips side to move and clears en passant (null-move pruning)
+    /// Must not be called while in check.
+    void make_null_move() const;
+
+    /// Undo make_null_move()
+    void undo_null_move() const;
+
     /// Get move history
     [[nodiscard]] std::vector<Move> move_history() const;
 
@@ -90,6 +150,10 @@ public:
     /// Is the current side in check?
     [[nodiscard]] bool is_in_check() const;
 
+    /// Does the side to move have at least one legal move?
+    /// Stops at the first one found instead of generating the full list
+    [[nodiscard]] bool has_legal_move() const;
+
     /// Is current position checkmate?
     [[nodiscard]] bool is_checkmate() const;
 
@@ -121,6 +185,27 @@ public:
     /// Get piece square hash (for transposition table, if needed)
     [[nodiscard]] Hash zobrist_hash() const;
 
+    /// Hash of the pawns alone (see ZobristHasher::compute_pawns)
+    [[nodiscard]] Hash pawn_hash() const;
+
+    // === NNUE ===
+
+    /// Keep first-layer accumulators for `network` from now on: make/unmake record
+    /// the pieces each move touches and accumulator() replays them on demand.
+    /// nullptr detaches. Copies of the board share the network, not the accumulators
+    void attach_network(std::shared_ptr<const NnueNetwork> network) const;
+
+    /// The attached network, or nullptr
+    [[nodiscard]] const NnueNetwork* network() const;
+
+    /// Accumulator of the current position, brought up to date lazily.
+    /// Requires an attached network
+    [[nodiscard]] const nnue::Accumulator& accumulator() const;
+
+    /// Raw position state: bitboards, mailbox and incrementally updated eval terms.
+    /// Copying the returned Position takes a snapshot (trivially copyable, no allocation)
+    [[nodiscard]] const Position& position() const;
+
     /// Check if position is legal (no double checks, etc)
     [[nodiscard]] bool is_valid_position() const;
 
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <stop_token>
+
+#include "Board.hpp"
+#include "Nnue.hpp"
+#include "Search.hpp"
+#include "TimeManager.hpp"
+#include "types.hpp"
+
+namespace chess {
+
+    struct EnginePoolConfig {
+        int threads = 0;            // Searches running at once, each on its own Engine; 0 = one per hardware thread
+        SearchConfig search;        // Settings for every search; search.threads is best left at 1, tt_size_mb is unused
+        std::shared_ptr<const NnueNetwork> network;
+        int session_tt_mb = 4;      // Table of a session that holds one
+        size_t memory_mb = 1024;    // All session tables together: memory_mb / session_tt_mb of them at most
+    };
+
+    /// A search handed to the pool: its result, and the token to cut it short
+    struct PendingSearch {
+        std::future<SearchResult> result;
+        std::stop_source stop;
+
+        /// End the search, from any thread. It still completes, with the last
+        /// iteration it finished, or the first legal move if it finished none
+        void cancel() { stop.request_stop(); }
+    };
+
+    /// One game served by an EnginePool. Copies are handles to the same game;
+    /// its table goes back to the pool when the last one is destroyed
+    class EngineSession {
+    public:
+        /// Queue a search of `board`; the limits are Engine::find_best_move's
+        /// @throws std::logic_error once the pool has shut down
+        [[nodiscard]] PendingSearch find_best_move(const Board& board, Depth max_depth) const;
+        [[nodiscard]] PendingSearch find_best_move(const Board& board, std::chrono::milliseconds time_limit) const;
+        [[nodiscard]] PendingSearch find_best_move(const Board& board, const TimeControl& time_control) const;
+
+        /// A new game: give the table back, so the next search starts from an empty one
+        /// @throws std::logic_error while one of the session's searches is running
+        void new_game() const;
+
+        /// Does the session hold a table right now?
+        [[nodiscard]] bool resident() const;
+
+    private:
+        friend class EnginePool;
+        struct State;
+
+        explicit EngineSession(std::shared_ptr<State> state);
+        std::shared_ptr<State> state;
+    };
+
+    /// Serves many concurrent games from one set of search threads.
+    ///
+    /// Engines belong to the pool's threads, not to games, so per-engine state
+    /// (the pawn cache) exists once per thread; the network, book and tablebase
+    /// in the config are shared by all of them, as are the piece-square tables,
+    /// attack tables and Zobrist keys. A game brings only its transposition
+    /// table, drawn from a fixed budget: a session takes a table when its first
+    /// search starts and keeps it from move to move. Once every table is taken,
+    /// the idle session that searched least recently gives its table up (LRU)
+    /// and plays on later from an empty one: weaker for a move or two, never wrong.
+    ///
+    /// Searches run first come, first served. Each returns a future and a stop
+    /// source; cancelling ends the search within time_check_nodes nodes, or at
+    /// once if it is still queued.
+    class EnginePool {
+    public:
+        /// @throws std::invalid_argument if memory_mb can't hold a table for every thread
+        explicit EnginePool(const EnginePoolConfig& config);
+
+        /// Cancels every search still queued or running, completes their futures
+        /// and joins the threads. Sessions may outlive the pool, but can't search
+        ~EnginePool();
+
+        EnginePool(const EnginePool&) = delete;
+        EnginePool& operator=(const EnginePool&) = delete;
+
+        [[nodiscard]] EngineSession open_session() const;
+
+        [[nodiscard]] int thread_count() const;
+        [[nodiscard]] size_t table_limit() const;       // memory_mb / session_tt_mb
+        [[nodiscard]] size_t resident_tables() const;   // Allocated so far, never more than table_limit
+        [[nodiscard]] uint64_t reclaimed_tables() const; // Taken from idle sessions so far
+
+    private:
+        friend class EngineSession;
+        class Impl;
+        std::shared_ptr<Impl> impl;
+    };
+
+}  // namespace chess
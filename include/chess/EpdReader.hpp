@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "internal/MappedFile.hpp"
+
+namespace chess {
+
+    /// One EPD line, as views into the reader's text
+    struct EpdRecord {
+        std::string_view fen;           // The four position fields, and the clocks when the line is a full FEN;
+                                        // ready for Board::load_fen
+        std::string_view clocks;        // Just the clocks, empty on a plain EPD line
+        std::string_view operations;    // Everything after the position: `opcode operands;` ...
+
+        /// Operand text of the first operation with this opcode, one layer of
+        /// quotes removed ("id \"x\";" gives x); nothing if there is none.
+        /// An opcode without operands gives an empty view
+        [[nodiscard]] std::optional<std::string_view> operation(std::string_view opcode) const;
+    };
+
+    /// Reads EPD (or plain FEN) lines in place, from caller-owned text or a
+    /// memory-mapped file; records are views into it, so reading allocates nothing.
+    /// Blank lines and lines starting with `#` are skipped
+    class EpdReader {
+    public:
+        /// Reads `text`, which must outlive the reader and its records
+        explicit EpdReader(std::string_view text);
+
+        /// Map a file and read it
+        /// @throws std::runtime_error if the file can't be opened
+        [[nodiscard]] static EpdReader open(const std::string& path);
+
+        /// The next record, false at the end of the text
+        /// @throws std::invalid_argument on a line with fewer than four fields
+        bool next(EpdRecord& record);
+
+        /// Split one line; false for blank and comment lines
+        /// @throws std::invalid_argument on fewer than four fields
+        static bool parse(std::string_view line, EpdRecord& record);
+
+        /// Bytes consumed so far
+        [[nodiscard]] size_t offset() const { return pos; }
+
+    private:
+        internal::MappedFile file;
+        std::string_view text;
+        size_t pos = 0;
+    };
+
+}  // namespace chess
@@ -6,10 +6,13 @@
 
 namespace chess {
 
+    class NnueNetwork;
+
     class Evaluator {
     public:
+        /// Scores come from the constexpr piece-square tables (see psq_midgame),
+        /// whose sums Board maintains incrementally
         Evaluator();
-        explicit Evaluator(const PieceSquareTables& pst);
         ~Evaluator();
 
         /// Evaluate position from perspective of side to move
@@ -22,13 +25,21 @@ namespace chess {
         /// @return Score in centipawns (positive = white winning)
         Score evaluate_white(const Board& board) const;
 
-        /// Get material balance (in centipawns)
+        /// Get material balance (in centipawns) from the side to move's perspective
         /// Simple piece count without positional factors
         Score material_count(const Board& board) const;
 
-        /// Estimate phase: 0.0 (endgame) to 1.0 (midgame opening)
+        /// Estimate phase: 0 (endgame) to 256 (midgame opening)
         double get_phase(const Board& board) const;
 
+        /// Evaluate with an NNUE network instead of the piece-square tables;
+        /// nullptr goes back to them. Not safe while a search is using this evaluator.
+        /// Boards attached to the same network (Board::attach_network) are
+        /// evaluated incrementally, others by a full refresh per call
+        void set_network(std::shared_ptr<const NnueNetwork> network);
+
+        [[nodiscard]] const std::shared_ptr<const NnueNetwork>& network() const;
+
     private:
         class Impl;
         std::unique_ptr<Impl> impl;
@@ -2,6 +2,7 @@
 
 #include <array>
 #include <stdexcept>
+#include <utility>
 
 #include "types.hpp"
 
@@ -40,21 +41,59 @@ namespace chess {
 
         // Conversion to/from algebraic notation
         [[nodiscard]] std::string to_uci() const;
+        /// Parses "e2e4" / "e7e8q". Only the promotion flag can be recovered from the
+        /// string, so match from/to/promotion against generated moves for the full move
         static Move from_uci(const std::string& uci_str);
 
         [[nodiscard]] uint32_t raw() const { return data; }
+
+        /// 16-bit form for compact storage: from:6 | to:6 | code:4, where code is
+        /// the flag for ordinary moves and 8 + (promotion - KNIGHT) for promotions
+        [[nodiscard]] uint16_t compact() const {
+            const unsigned code = is_promotion() ? 8 + (static_cast<int>(promotion()) - static_cast<int>(PieceType::KNIGHT))
+                                                 : static_cast<int>(flag());
+            return static_cast<uint16_t>((data & 0xFFF) | code << 12);
+        }
+
+        /// Inverse of compact(); 0 maps back to the null move
+        static Move from_compact(const uint16_t packed) {
+            if (packed == 0) return {};
+
+            const auto from = Square(packed & 0x3F);
+            const auto to = Square((packed >> 6) & 0x3F);
+            const unsigned code = packed >> 12;
+            if (code >= 8)
+                return {from, to, MoveFlag::PROMOTION, PieceType(static_cast<int>(PieceType::KNIGHT) + (code - 8))};
+            return {from, to, MoveFlag(code)};
+        }
     };
 
     // Move list for generator
     class MoveList {
     private:
         std::array<Move, 256> moves;
+        std::array<int32_t, 256> scores;  // Ordering scores, only meaningful once set
         size_t count = 0;
 
     public:
         void add(const Move m) { moves[count++] = m; }
         void clear() { count = 0; }
 
+        // Move ordering
+        void set_score(const size_t idx, const int32_t score) { scores[idx] = score; }
+        [[nodiscard]] int32_t score(const size_t idx) const { return scores[idx]; }
+
+        /// Lazy selection: swap the best-scored move in [idx, size) into idx and return it
+        Move pick_best(const size_t idx) {
+            size_t best = idx;
+            for (size_t i = idx + 1; i < count; ++i)
+                if (scores[i] > scores[best]) best = i;
+
+            std::swap(moves[idx], moves[best]);
+            std::swap(scores[idx], scores[best]);
+            return moves[idx];
+        }
+
         [[nodiscard]] size_t size() const { return count; }
         [[nodiscard]] bool empty() const { return count == 0; }
 
@@ -16,11 +16,16 @@ namespace chess {
             board.generate_moves(moves);
         }
 
-        /// Generate only captures and promotions
+        /// Generate only captures and queen promotions
         static void generate_tactical_moves(const Board& board, MoveList& moves) {
             board.generate_captures(moves);
         }
 
+        /// Generate only non-tactical moves
+        static void generate_quiet_moves(const Board& board, MoveList& moves) {
+            board.generate_quiets(moves);
+        }
+
         /// Check if a specific move is legal
         static bool is_legal(const Board& board, const Move& move) {
             return board.is_legal_move(move);
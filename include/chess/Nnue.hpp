@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+
+#include "types.hpp"
+#include "internal/MappedFile.hpp"
+
+namespace chess {
+
+    // ============================================================================
+    // NNUE evaluation
+    //
+    // A king-bucketed HalfKA network: each side's half of the first layer sees all
+    // pieces (kings included) from that side's point of view, indexed by
+    //
+    //     king bucket * 768 + (own/their piece type) * 64 + square
+    //
+    // with black's view flipped vertically so both halves share weights. The
+    // first layer's output (the accumulator) is updated incrementally as pieces
+    // move; a refresh from scratch is only needed when a king changes bucket.
+    // The accumulators pass through a clipped ReLU into a single output neuron,
+    // side to move's half first.
+    // ============================================================================
+
+    namespace nnue {
+        inline constexpr int KING_BUCKETS = 4;
+        inline constexpr int INPUTS = KING_BUCKETS * 768;
+        inline constexpr int HIDDEN = 256;
+
+        // Quantisation: accumulators are scaled by QA, output weights by QB, and
+        // the network output is in units of EVAL_SCALE centipawns
+        inline constexpr int QA = 255;
+        inline constexpr int QB = 64;
+        inline constexpr int EVAL_SCALE = 400;
+
+        /// Pieces a move put down or picked up; `from` is INVALID for a piece
+        /// added, `to` is INVALID for a piece removed. A capturing promotion
+        /// touches four
+        struct DirtyPiece {
+            Piece piece;
+            Square from;
+            Square to;
+        };
+
+        struct DirtyPieces {
+            DirtyPiece pieces[4];
+            uint8_t count = 0;
+
+            void push(const Piece piece, const Square from, const Square to) {
+                pieces[count++] = { piece, from, to };
+            }
+        };
+
+        /// First-layer output for both perspectives, plus the piece changes of
+        /// the move that led to it. `computed` is per perspective: a king move
+        /// only invalidates its own side's half
+        struct alignas(64) Accumulator {
+            int16_t values[2][HIDDEN];
+            bool computed[2] = { false, false };
+            DirtyPieces dirty;
+        };
+    }
+
+    /// Network weights, used in place from a memory-mapped file. Immutable once
+    /// loaded, so one network is shared by every engine and thread in the process.
+    ///
+    /// File layout (little-endian):
+    ///
+    ///     header                 64 bytes: magic "CNUE", version, KING_BUCKETS, HIDDEN, zero padding
+    ///     feature weights        int16[INPUTS][HIDDEN]
+    ///     feature biases         int16[HIDDEN]
+    ///     output weights         int16[2 * HIDDEN]   (side to move's half first)
+    ///     output bias            int32
+    class NnueNetwork {
+    public:
+        static constexpr uint32_t MAGIC = 0x45554E43;   // "CNUE"
+        static constexpr uint32_t VERSION = 1;
+        static constexpr size_t HEADER_BYTES = 64;
+        static constexpr size_t FILE_BYTES = HEADER_BYTES +
+            sizeof(int16_t) * ((size_t)nnue::INPUTS * nnue::HIDDEN + nnue::HIDDEN + 2 * nnue::HIDDEN) +
+            sizeof(int32_t);
+
+        /// @throws std::runtime_error if the file is missing or isn't a network
+        ///         of this architecture
+        [[nodiscard]] static std::shared_ptr<const NnueNetwork> load(const std::string& path);
+
+        /// Side to move's score in centipawns for an up-to-date accumulator
+        [[nodiscard]] Score evaluate(const nnue::Accumulator& acc, Color side_to_move) const;
+
+        /// Rebuild one perspective of `acc` from the pieces on the board
+        void refresh(nnue::Accumulator& acc, const Position& pos, Color perspective) const;
+
+        /// Bring the top of an accumulator stack (one entry per ply, the board's
+        /// position last) up to date: replay dirty pieces forward from the nearest
+        /// computed entry, or refresh when a king changed bucket on the way
+        void update(std::span<nnue::Accumulator> stack, const Position& pos) const;
+
+        [[nodiscard]] static int feature_index(Color perspective, Square king, Piece piece, Square sq);
+        [[nodiscard]] static int king_bucket(Color perspective, Square king);
+
+    private:
+        internal::MappedFile file;
+        const int16_t* feature_weights = nullptr;
+        const int16_t* feature_biases = nullptr;
+        const int16_t* output_weights = nullptr;
+        int32_t output_bias = 0;
+
+        explicit NnueNetwork(internal::MappedFile file);
+
+        [[nodiscard]] const int16_t* row(const int feature) const {
+            return feature_weights + (size_t)feature * nnue::HIDDEN;
+        }
+    };
+
+}  // namespace chess
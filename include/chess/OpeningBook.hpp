@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Board.hpp"
+#include "Move.hpp"
+#include "types.hpp"
+#include "internal/MappedFile.hpp"
+
+namespace chess {
+
+    /// How to choose between several book moves
+    enum class BookSelection : uint8_t {
+        BEST,       // Highest weight, first in file order on ties
+        WEIGHTED,   // Random, in proportion to weight
+    };
+
+    struct BookMove {
+        Move move;
+        uint16_t weight;
+    };
+
+    /// Polyglot (.bin) opening book, probed in place from a memory-mapped file.
+    ///
+    /// The file is a sorted array of 16-byte big-endian entries
+    ///
+    ///     key:64 | move:16 | weight:16 | learn:32
+    ///
+    /// so a probe is a binary search for the first entry with the position's key
+    /// and a scan over the run that follows; nothing is copied onto the heap. The
+    /// book is immutable once open, so one mapping serves every engine and thread
+    /// in the process (pass the same shared_ptr around).
+    class OpeningBook {
+    public:
+        static constexpr size_t ENTRY_BYTES = 16;
+
+        /// @throws std::runtime_error if the file is missing or not a whole number of entries
+        [[nodiscard]] static std::shared_ptr<const OpeningBook> open(const std::string& path);
+
+        /// Legal book moves for the position, in file order (highest weight first
+        /// in books built by the usual tools). Entries naming no legal move are skipped
+        [[nodiscard]] std::vector<BookMove> moves(const Board& board) const;
+
+        /// One book move, or nothing when the position isn't in the book
+        [[nodiscard]] std::optional<Move> probe(const Board& board, BookSelection selection,
+                                                std::mt19937_64& rng) const;
+
+        /// Number of entries in the file
+        [[nodiscard]] size_t size() const { return count; }
+
+        /// Polyglot hash of a position: pieces, castling rights, en passant file
+        /// only when a pawn can actually capture there, and white to move.
+        /// Separate from ZobristHasher's keys, which may change without breaking books
+        [[nodiscard]] static uint64_t key(const Position& pos);
+
+        /// Polyglot's 16-bit move encoding (castling as king takes own rook)
+        [[nodiscard]] static uint16_t encode_move(Move move);
+
+    private:
+        internal::MappedFile file;
+        size_t count = 0;
+
+        explicit OpeningBook(internal::MappedFile file);
+
+        [[nodiscard]] uint64_t key_at(size_t index) const;
+    };
+
+}  // namespace chess
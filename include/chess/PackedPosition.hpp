@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <span>
+
+#include "types.hpp"
+#include "internal/MappedFile.hpp"
+
+namespace chess {
+
+    /// A position in 32 bytes, for datasets of billions of positions.
+    ///
+    ///     occupancy:64 | pieces:128 | fullmove:16 | score:16 | state:8 | en passant:8 | halfmove:8 | result:8
+    ///
+    /// `pieces` holds one nibble per occupied square in ascending square order,
+    /// low nibble first, each the Piece value (white pawn 0 .. black king 11).
+    /// Multi-byte fields are little-endian on every host, so files move between
+    /// machines and read back with a plain copy. `score` and `result` are free
+    /// for labels (a search score, the game's outcome) and are 0 from pack().
+    struct PackedPosition {
+        uint64_t occupancy;
+        uint8_t pieces[16];
+        uint16_t fullmove_number;   // Saturates at 65535
+        int16_t score;
+        uint8_t state;              // Bit 0: black to move; bits 1-4: castling rights
+        uint8_t en_passant;         // Square, 64 for none
+        uint8_t halfmove_clock;     // Saturates at 255
+        int8_t result;
+
+        [[nodiscard]] static PackedPosition pack(const Position& pos);
+
+        /// The full Position, hashes and evaluation terms included
+        /// @throws std::invalid_argument if the record is corrupt
+        [[nodiscard]] Position unpack() const;
+
+        /// Write records as they are in memory
+        /// @throws std::runtime_error if the stream fails
+        static void write(std::ostream& out, std::span<const PackedPosition> positions);
+
+        /// Fill as much of `buffer` as the stream has; the number of whole records read
+        static size_t read(std::istream& in, std::span<PackedPosition> buffer);
+
+        /// The records of a mapped file, in place
+        /// @throws std::invalid_argument if the file isn't a whole number of records
+        [[nodiscard]] static std::span<const PackedPosition> view(const internal::MappedFile& file);
+    };
+
+    static_assert(sizeof(PackedPosition) == 32);
+    static_assert(std::is_trivially_copyable_v<PackedPosition>);
+
+}  // namespace chess
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include "types.hpp"
+
+namespace chess {
+
+    /// Pawn structure terms, white minus black, as midgame and endgame halves
+    /// that the evaluator tapers with the rest of the score
+    struct PawnScore {
+        Score midgame = 0;
+        Score endgame = 0;
+    };
+
+    /// Doubled, isolated, backward and passed pawn terms. Depends on the pawn
+    /// bitboards alone, so the result can be cached under Position::pawn_hash
+    [[nodiscard]] PawnScore evaluate_pawn_structure(const Position& pos);
+
+    /// Midgame bonus for `color`'s own pawns in front of the king while it sits
+    /// on its first two ranks. Depends on the king square, so it is never cached
+    [[nodiscard]] Score king_pawn_shield(const Position& pos, Color color);
+
+    /// king_pawn_shield for white minus black
+    [[nodiscard]] Score king_pawn_shields(const Position& pos);
+
+    /// Small always-replace cache of evaluate_pawn_structure results.
+    /// Each entry is one atomic word
+    ///
+    ///     key:32 | midgame:16 | endgame:16
+    ///
+    /// with the key taken from the top half of the pawn hash, so search threads
+    /// sharing an Evaluator read and write it without locks and never see a torn
+    /// entry. Pawn structures repeat across most of the tree, so even a table
+    /// that fits in L2 hits almost every probe.
+    class PawnHashTable {
+    public:
+        static constexpr size_t DEFAULT_ENTRIES = 1 << 14;
+
+        /// @param entries Table size, rounded down to a power of two
+        explicit PawnHashTable(size_t entries = DEFAULT_ENTRIES);
+
+        /// Cached pawn structure for the position, computed and stored on a miss
+        [[nodiscard]] PawnScore probe(const Position& pos);
+
+        void clear();
+
+    private:
+        std::unique_ptr<std::atomic<uint64_t>[]> table;
+        size_t mask;
+    };
+
+}  // namespace chess
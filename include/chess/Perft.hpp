@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "Board.hpp"
+#include "Move.hpp"
+
+namespace chess {
+
+// ============================================================================
+// Perft - Move Generator Node Counting
+// ============================================================================
+
+struct PerftConfig {
+    int threads = 1;        // Root moves are shared out across this many threads
+    size_t hash_mb = 0;     // Subtree counts cached by (zobrist_hash, depth); 0 disables
+};
+
+/// Count the leaves of the legal move tree `depth` plies deep.
+/// The last ply is bulk-counted from the move list instead of being played.
+[[nodiscard]] uint64_t perft(const Board& board, int depth, const PerftConfig& config = {});
+
+/// perft split by root move, in generation order
+[[nodiscard]] std::vector<std::pair<Move, uint64_t>> divide(const Board& board, int depth,
+                                                            const PerftConfig& config = {});
+
+}  // namespace chess
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Board.hpp"
+#include "Move.hpp"
+#include "internal/MappedFile.hpp"
+
+namespace chess {
+
+    struct PgnTag {
+        std::string_view name;
+        std::string_view value;     // Without the quotes; escapes are left as written
+    };
+
+    /// One game, as views into the reader's text. Reuse the same PgnGame for
+    /// every game: the tag list keeps its capacity, so reading doesn't allocate
+    struct PgnGame {
+        std::vector<PgnTag> tags;
+        std::string_view movetext;  // Moves, comments and variations, up to and including the result
+        std::string_view result;    // 1-0, 0-1, 1/2-1/2 or *; empty if the game text gave none
+
+        /// Value of the first tag with this name, empty if there is none
+        [[nodiscard]] std::string_view tag(std::string_view name) const;
+    };
+
+    /// Reads PGN games in place, from caller-owned text or a memory-mapped file
+    class PgnReader {
+    public:
+        /// Reads `text`, which must outlive the reader and its games
+        explicit PgnReader(std::string_view text);
+
+        /// Map a file and read it
+        /// @throws std::runtime_error if the file can't be opened
+        [[nodiscard]] static PgnReader open(const std::string& path);
+
+        /// Split off the next game's tags and movetext; false at the end of the text.
+        /// A game ends at its result, or where the next one's tags begin
+        /// @throws std::invalid_argument on an unterminated tag
+        bool next(PgnGame& game);
+
+        /// Play the game's main line on `board`, from its FEN tag or the initial
+        /// position. on_move sees each position with the move about to be played
+        /// from it; comments, variations, NAGs and move numbers are skipped. The
+        /// board's history is cleared whenever it would overflow MAX_GAME_PLIES.
+        /// Returns the number of moves played
+        /// @throws std::invalid_argument on a bad FEN or a move that isn't legal (see Board::parse_san)
+        static size_t replay(const PgnGame& game, const Board& board,
+                             const std::function<void(const Board&, Move)>& on_move = {});
+
+        /// Bytes consumed so far
+        [[nodiscard]] size_t offset() const { return pos; }
+
+    private:
+        internal::MappedFile file;
+        std::string_view text;
+        size_t pos = 0;
+    };
+
+}  // namespace chess
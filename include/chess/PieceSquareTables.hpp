@@ -164,6 +164,30 @@ namespace chess {
         -6,  -4,  -2,   0,   0,  -2,  -4,  -6,
     };
 
+    // Game phase weight per piece type (N = B = 1, R = 2, Q = 4): 24 in the opening
+    constexpr int PHASE_WEIGHTS[6] = { 0, 1, 1, 2, 4, 0 };
+    constexpr int MAX_PHASE = 24;
+
+    constexpr const int* MIDGAME_TABLES[6] = { PAWN_MG, KNIGHT_MG, BISHOP_MG, ROOK_MG, QUEEN_MG, KING_MG };
+    constexpr const int* ENDGAME_TABLES[6] = { PAWN_EG, KNIGHT_EG, BISHOP_EG, ROOK_EG, QUEEN_EG, KING_EG };
+
+    /// Material plus midgame bonus of a piece on a square, signed from white's perspective.
+    /// Black reads the tables with the rank flipped.
+    [[nodiscard]] constexpr int psq_midgame(const Piece p, const Square sq) {
+        const int type = (int)p % 6;
+        const bool black = (int)p >= 6;
+        const int value = (int)PIECE_VALUES[type] + MIDGAME_TABLES[type][black ? (int)sq ^ 56 : (int)sq];
+        return black ? -value : value;
+    }
+
+    /// Material plus endgame bonus of a piece on a square, signed from white's perspective.
+    [[nodiscard]] constexpr int psq_endgame(const Piece p, const Square sq) {
+        const int type = (int)p % 6;
+        const bool black = (int)p >= 6;
+        const int value = (int)PIECE_VALUES[type] + ENDGAME_TABLES[type][black ? (int)sq ^ 56 : (int)sq];
+        return black ? -value : value;
+    }
+
     class PieceSquareTables {
     private:
         // Tables for each piece type (endgame and midgame)
@@ -3,36 +3,105 @@
 #include "types.hpp"
 #include "Board.hpp"
 #include "Move.hpp"
+#include "Nnue.hpp"
+#include "OpeningBook.hpp"
+#include "Tablebase.hpp"
+#include "TimeManager.hpp"
 
 #include <chrono>
 #include <functional>
 #include <vector>
 #include <optional>
+#include <stop_token>
 
 namespace chess {
 
-inline constexpr int MAX_DEPTH = 32;
+class TranspositionTable;
 
 // ============================================================================
 // Search Configuration & Results
 // ============================================================================
 
+/// One root move as the last completed iteration left it
+struct RootMove {
+    Move move;
+    Score score;        // Exact for the best move; an upper bound for moves proven no better
+    uint64_t nodes;     // Size of its subtree (main thread)
+};
+
+/// Counters for a search so far, summed over its threads. Each thread counts
+/// into its own fields, so counting costs no shared writes; a build with
+/// SEARCH_STATS=OFF (CHESS_NO_SEARCH_STATS) compiles out everything but nodes
+struct SearchStats {
+    uint64_t nodes = 0;                 // Main search and quiescence
+    uint64_t qnodes = 0;                // Quiescence only
+    uint64_t tt_probes = 0;
+    uint64_t tt_hits = 0;               // Probes that found the position
+    uint64_t tt_cutoffs = 0;            // Hits deep and tight enough to return their score
+    uint64_t tt_collisions = 0;         // Hits whose move is illegal here: another position under the same key bits
+    uint64_t tb_hits = 0;
+    uint64_t cutoffs = 0;               // Beta cutoffs in the main search
+    uint64_t first_move_cutoffs = 0;    // ... on the first move searched
+    int seldepth = 0;                   // Deepest ply reached, quiescence included
+    int hashfull = 0;                   // Per mille of the TT written by the current search (sampled)
+
+    /// Share of cutoffs on the first move, a measure of move ordering (1 is perfect)
+    [[nodiscard]] double first_move_cutoff_rate() const {
+        return cutoffs ? (double)first_move_cutoffs / (double)cutoffs : 0;
+    }
+
+    [[nodiscard]] double tt_hit_rate() const {
+        return tt_probes ? (double)tt_hits / (double)tt_probes : 0;
+    }
+};
+
+/// One completed iteration of iterative deepening
+struct IterationStats {
+    Depth depth;
+    uint64_t nodes;             // Searched by this iteration alone, all threads
+    double time;                // Seconds this iteration took
+    double nps;
+    double branching_factor;    // Effective: nodes over the previous iteration's, 0 at the first
+    int seldepth;               // Deepest ply reached so far
+};
+
 struct SearchResult {
     Move best_move;
     Score score;
     Depth depth;
-    uint64_t nodes_searched;
+    uint64_t nodes_searched;    // Summed over all search threads
     double search_time;
+    std::vector<Move> pv;               // Principal variation, best_move first
+    std::vector<RootMove> root_moves;   // All legal root moves, best score first
+    SearchStats stats;                  // As of the last completed iteration; the whole search in the final result
+    std::vector<IterationStats> iterations;     // Every completed iteration, shallowest first
 };
 
 struct SearchConfig {
     std::chrono::milliseconds time_limit = std::chrono::milliseconds(5000);
     int max_depth = 20;
     int tt_size_mb = 64;
+    int threads = 1;            // Lazy SMP: helper threads search the same root and share the TT
     bool use_transposition_table = true;
     bool use_quiescence_search = true;
     bool use_move_ordering = true;
-    std::function<void(const SearchResult&)> on_iteration_complete;
+    bool use_qsearch_pruning = true;    // Skip SEE-losing and delta-hopeless captures in quiescence
+    bool use_pvs = true;                // Zero-window search after the first move, re-searched if it beats alpha
+    bool use_aspiration_windows = true; // Root window around the previous iteration's score
+    bool use_null_move_pruning = true;
+    bool use_late_move_reductions = true;
+    bool use_futility_pruning = true;   // Reverse futility at the node and futility on quiet moves
+    bool use_check_extensions = true;
+    bool use_move_stability = true;     // Clock searches stop early on a settled best move, run long on a changing one
+    int time_check_nodes = 2048;        // Nodes between clock polls inside the search
+    uint64_t node_limit = 0;            // Stop once the main thread has searched this many nodes; 0 = no limit
+    bool use_copy_make = false;     // Undo moves by restoring a Position snapshot instead of unmaking
+    std::shared_ptr<const OpeningBook> book;    // Timed searches play a book move without searching when there is one
+    BookSelection book_selection = BookSelection::WEIGHTED;
+    std::shared_ptr<const Tablebase> tablebase; // Exact scores for endings it covers, and only winning root moves
+    int tablebase_probe_depth = 1;              // Shallowest remaining depth that probes inside the tree
+    std::stop_token stop_token;     // A stop request ends the search like stop_search(), from any thread
+    std::function<void(const SearchResult&)> on_iteration_complete;     // With stats and iterations so far
 };
 
 // ============================================================================
@@ -43,19 +112,42 @@ class Engine {
 public:
     Engine();
     explicit Engine(const SearchConfig& config);
+
+    /// Search with a transposition table shared with other engines instead of
+    /// one of config.tt_size_mb; they may search concurrently (see BatchAnalyzer)
+    Engine(const SearchConfig& config, std::shared_ptr<TranspositionTable> table);
     ~Engine();
 
     void set_config(const SearchConfig& config) const ;
     [[nodiscard]] SearchConfig get_config() const;
+
+    /// Resize or clear this engine's table; a shared one changes for every engine
+    /// using it, so none of them may be searching
     void set_tt_size(int mb) const;
     void clear_cache() const;
 
+    /// Search with `table` from the next search on (see EnginePool); not while searching.
+    /// An engine constructed or left with a null table can't search until it gets one
+    void set_table(std::shared_ptr<TranspositionTable> table) const;
+
+    /// Evaluate with an NNUE network (see NnueNetwork::load); nullptr goes back to
+    /// the piece-square tables. Call between searches. A network can be shared by
+    /// any number of engines
+    void set_network(std::shared_ptr<const NnueNetwork> network) const;
+
+    /// Search for the given time; the limit is a hard deadline that aborts mid-iteration
+    /// and returns the last completed iteration's move
     [[nodiscard]] SearchResult find_best_move(Board board, std::chrono::milliseconds time_limit) const;
+
+    /// Search with a budget taken from the game clock (soft and hard deadlines, see TimeManager)
+    [[nodiscard]] SearchResult find_best_move(Board board, const TimeControl& time_control) const;
     [[nodiscard]] SearchResult find_best_move(Board board, Depth max_depth) const;
     [[nodiscard]] SearchResult find_best_move(Board board, int max_depth, std::chrono::milliseconds time_limit) const;
 
     [[nodiscard]] Score evaluate(const Board& board) const;
 
+    /// Up to `depth` moves of the principal variation: the last search's own line when
+    /// `board` is the position it searched, otherwise whatever the TT still holds
     [[nodiscard]] std::vector<Move> get_principal_variation(Board board, int depth) const;
     [[nodiscard]] MoveList get_ranked_moves(const Board& board) const;
 
@@ -72,6 +164,9 @@ public:
     void set_progress_callback(const std::function<void(int depth, uint64_t nodes)>& callback);
     void stop_search() const;
 
+    /// The pondered move was played: a `ponder` TimeControl search starts running to its deadlines
+    void ponder_hit() const;
+
 private:
     class Impl;
     std::unique_ptr<Impl> impl;
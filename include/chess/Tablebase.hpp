@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "types.hpp"
+#include "internal/MappedFile.hpp"
+
+namespace chess {
+
+    enum class Wdl : int8_t { LOSS = -1, DRAW = 0, WIN = 1 };
+
+    /// A tablebase verdict for the side to move
+    struct TablebaseResult {
+        Wdl wdl;
+        int dtm;    // Plies to mate with best play (0 when checkmated or drawn)
+    };
+
+    /// Endgame tablebases for every position with at most three pieces (two
+    /// kings and one more), probed in place from memory-mapped files.
+    ///
+    /// KQvK, KRvK and KPvK each have a file of one byte per position
+    ///
+    ///     index = ((side to move * 64 + white king) * 64 + black king) * 64 + piece
+    ///
+    /// written for the piece on white's side; the same positions with colors
+    /// swapped are probed through the mirror image. A byte of 0 is a draw, any
+    /// other value v is mate in v - 1 plies, a win for the side to move when that
+    /// is odd. KvK, KBvK and KNvK are draws and need no file. Values are
+    /// distance to mate rather than Syzygy's distance to zeroing: with three
+    /// pieces every mate lies well inside the fifty-move rule.
+    ///
+    /// The tables are immutable once open, so any number of search threads and
+    /// engines probe one Tablebase without locks.
+    class Tablebase {
+    public:
+        static constexpr uint32_t MAGIC = 0x31425443;   // "CTB1"
+        static constexpr size_t HEADER_BYTES = 16;
+        static constexpr size_t TABLE_ENTRIES = 2 * 64 * 64 * 64;
+
+        /// Map whichever table files are in `directory`; missing ones aren't probed
+        /// @throws std::runtime_error if a file is present but isn't a table
+        [[nodiscard]] static std::shared_ptr<const Tablebase> open(const std::string& directory);
+
+        /// Solve all three-piece endings by retrograde analysis and write their
+        /// files into `directory` (a few seconds; see tools/tbgen.cpp)
+        static void generate(const std::string& directory);
+
+        /// File name of the table for a piece type (KQvK.ctb, ...)
+        [[nodiscard]] static std::string file_name(PieceType type);
+
+        /// Result for the position, or nothing if it has more pieces than the
+        /// tables cover, castling rights, or its table wasn't found
+        [[nodiscard]] std::optional<TablebaseResult> probe(const Position& pos) const;
+
+        /// Most pieces any loaded table covers (2 with no files at all)
+        [[nodiscard]] int cardinality() const { return max_pieces; }
+
+    private:
+        // Indexed by the third piece's type; only queen, rook and pawn have files
+        std::array<internal::MappedFile, 6> files;
+        std::array<const uint8_t*, 6> tables {};
+        int max_pieces = 2;
+
+        Tablebase() = default;
+    };
+
+}  // namespace chess
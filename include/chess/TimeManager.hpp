@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "Move.hpp"
+
+namespace chess {
+
+// ============================================================================
+// Time Management - Per-Move Budgets from the Game Clock
+// ============================================================================
+
+/// Clock situation for one move, as a GUI reports it (UCI go wtime/winc/movestogo/movetime)
+struct TimeControl {
+    std::chrono::milliseconds remaining{0};     // Our clock
+    std::chrono::milliseconds increment{0};     // Added after each of our moves
+    int moves_to_go = 0;                        // Moves until the clock is topped up; 0 = sudden death
+    std::chrono::milliseconds move_time{0};     // Fixed time for this move; overrides the clock when set
+    std::chrono::milliseconds overhead{20};     // Kept back for GUI and network lag
+    bool ponder = false;                        // Thinking on the opponent's time until ponder_hit()
+};
+
+/// Deadlines for one search, measured on steady_clock from start().
+///
+/// The hard deadline is absolute: the search polls it and aborts mid-iteration.
+/// The soft deadline only decides whether the next iteration is worth starting:
+/// it is stretched while the best move keeps changing, shrunk while it is stable,
+/// and an iteration the measured branching factor says can't finish before the
+/// hard deadline is never started.
+///
+/// While pondering neither deadline applies. They are counted from start(), so
+/// after a late ponder_hit() the search stops almost at once with a deep result.
+class TimeManager {
+public:
+    using clock = std::chrono::steady_clock;
+
+    /// Budget a move from the clock
+    void start(const TimeControl& tc, bool use_stability = true);
+
+    /// Fixed budget: both deadlines at `limit`
+    void start(std::chrono::milliseconds limit);
+
+    /// No deadlines: the search runs to its depth limit or an explicit stop
+    void start_infinite();
+
+    [[nodiscard]] std::chrono::milliseconds elapsed() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - start_time);
+    }
+
+    [[nodiscard]] double elapsed_seconds() const {
+        return std::chrono::duration<double>(clock::now() - start_time).count();
+    }
+
+    /// Polled from inside the search every few thousand nodes
+    [[nodiscard]] bool hard_expired() const {
+        return timed && !pondering.load(std::memory_order_relaxed) && clock::now() >= hard_deadline;
+    }
+
+    /// The opponent played the expected move: the deadlines apply from now on (any thread)
+    void ponder_hit() { pondering.store(false, std::memory_order_relaxed); }
+
+    /// Record a completed iteration and its best move
+    void iteration_complete(Move best_move);
+
+    /// Is there time to start another iteration?
+    [[nodiscard]] bool should_continue() const;
+
+    [[nodiscard]] std::chrono::milliseconds soft_limit() const { return soft; }
+    [[nodiscard]] std::chrono::milliseconds hard_limit() const { return hard; }
+
+private:
+    clock::time_point start_time = clock::now();
+    clock::time_point hard_deadline = start_time;
+    std::chrono::milliseconds soft{0};
+    std::chrono::milliseconds hard{0};
+    bool timed = false;
+    bool use_stability = false;
+    std::atomic<bool> pondering = false;
+
+    // Iteration history for the branching factor and best-move stability
+    clock::duration last_iteration{0};
+    clock::duration previous_iteration{0};
+    clock::time_point iteration_start = start_time;
+    Move last_best;
+    int stability = 0;        // Consecutive iterations with the same best move
+    bool best_changed = false;
+};
+
+}  // namespace chess
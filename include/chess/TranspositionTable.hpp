@@ -1,10 +1,12 @@
 #pragma once
 
 #include <algorithm>
-#include <vector>
+#include <atomic>
+#include <optional>
 
 #include "Move.hpp"
 #include "types.hpp"
+#include "internal/LargePages.hpp"
 
 namespace chess {
 
@@ -22,37 +24,172 @@ namespace chess {
         }
     };
 
+    /// Shared, lock-free transposition table.
+    /// The table is an array of cache-line buckets holding eight 64-bit entries:
+    ///
+    ///     key:16 | move:16 | score:16 | depth:8 | generation:6 | bound:2
+    ///
+    /// The bucket index comes from the low bits of the hash and the stored key from
+    /// the top 16 bits. An entry is a single atomic word, so concurrent readers and
+    /// writers never see a torn entry. Bound 0 marks an empty slot.
+    ///
+    /// The buckets live in a huge-page backed block (see internal::LargePageBuffer)
+    /// cleared by all hardware threads, so multi-GB tables start quickly and spread
+    /// across NUMA nodes.
+    ///
+    /// Several engines may share one table (see Engine's constructor); each
+    /// search started on any of them ages everyone's entries by a generation.
+    ///
+    /// Replacement keeps deep entries: a store overwrites the entry for the same
+    /// position (unless that entry is a deeper bound), otherwise the bucket's
+    /// shallowest entry, with entries from older searches aging towards eviction.
     class TranspositionTable {
     private:
-        std::vector<TTEntry> table;
-        size_t mask;
+        static constexpr int BUCKET_SIZE = 8;
+        static constexpr int GENERATION_CYCLE = 64;
+
+        // All-zero bytes are a valid bucket of empty entries (the atomics are
+        // lock-free integers), so the raw block is used without constructing them
+        struct alignas(64) Bucket {
+            std::atomic<uint64_t> entries[BUCKET_SIZE];
+        };
+        static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+        internal::LargePageBuffer memory;
+        Bucket* table = nullptr;
+        size_t bucket_count = 0;
+        size_t mask = 0;
+        std::atomic<uint8_t> generation = 0;  // Engines sharing the table each advance it per search
+
+        static uint16_t key_of(const Hash h) { return (uint16_t)(h >> 48); }
+        static uint16_t key_bits(const uint64_t e) { return (uint16_t)e; }
+        static uint16_t move_bits(const uint64_t e) { return (uint16_t)(e >> 16); }
+        static Score score_bits(const uint64_t e) { return (int16_t)(uint16_t)(e >> 32); }
+        static Depth depth_bits(const uint64_t e) { return (Depth)(uint8_t)(e >> 48); }
+        static uint8_t generation_bits(const uint64_t e) { return (uint8_t)((e >> 56) & 0x3F); }
+        static unsigned bound_bits(const uint64_t e) { return (unsigned)(e >> 62); }
+
+        static uint64_t pack(const uint16_t key, const uint16_t move, const Score s, const Depth d,
+                             const uint8_t gen, const Flag f) {
+            const auto score = (int16_t)std::clamp(s, (Score)INT16_MIN, (Score)INT16_MAX);
+            return (uint64_t)key |
+                   (uint64_t)move << 16 |
+                   (uint64_t)(uint16_t)score << 32 |
+                   (uint64_t)(uint8_t)d << 48 |
+                   (uint64_t)gen << 56 |
+                   (uint64_t)(f + 1) << 62;
+        }
+
+        /// Replacement value: deeper and more recent entries are worth more
+        [[nodiscard]] int worth(const uint64_t e) const {
+            const int age = (GENERATION_CYCLE + current_generation() - generation_bits(e)) % GENERATION_CYCLE;
+            return depth_bits(e) - 8 * age;
+        }
+
+        [[nodiscard]] Bucket& bucket_for(const Hash h) const { return table[h & mask]; }
+
+        [[nodiscard]] uint8_t current_generation() const { return generation.load(std::memory_order_relaxed); }
 
     public:
-        explicit TranspositionTable(const size_t mb_size): mask(0) {
+        explicit TranspositionTable(const size_t mb_size) {
             resize(mb_size);
         }
 
+        /// Start a new search: entries written before now begin to age
+        void new_search() {
+            generation.store((uint8_t)((current_generation() + 1) % GENERATION_CYCLE), std::memory_order_relaxed);
+        }
+
+        /// Hint the CPU to fetch the bucket for h, e.g. right after making a move
+        void prefetch(const Hash h) const { __builtin_prefetch(&bucket_for(h)); }
+
         void store(const Hash h, const Score s, const Depth d, const Flag f, const Move m) {
-            TTEntry& entry = table[h & mask];
-            entry = {h, s, d, f, m};
+            Bucket& bucket = bucket_for(h);
+            const uint16_t key = key_of(h);
+            const uint8_t current = current_generation();
+
+            std::atomic<uint64_t>* victim = &bucket.entries[0];
+            uint64_t victim_entry = victim->load(std::memory_order_relaxed);
+
+            for (auto& slot : bucket.entries) {
+                const uint64_t e = slot.load(std::memory_order_relaxed);
+
+                if (bound_bits(e) != 0 && key_bits(e) == key) {
+                    // Same position: keep a deeper bound from this search, and its move if we have none
+                    if (f != EXACT && generation_bits(e) == current && depth_bits(e) > d + 2)
+                        return;
+                    const uint16_t move = m == Move() ? move_bits(e) : m.compact();
+                    slot.store(pack(key, move, s, d, current, f), std::memory_order_relaxed);
+                    return;
+                }
+
+                if (bound_bits(victim_entry) != 0 && (bound_bits(e) == 0 || worth(e) < worth(victim_entry))) {
+                    victim = &slot;
+                    victim_entry = e;
+                }
+            }
+
+            victim->store(pack(key, m.compact(), s, d, current, f), std::memory_order_relaxed);
         }
 
         [[nodiscard]] std::optional<TTEntry> lookup(const Hash h, const Depth d) const {
-            if (const TTEntry& entry = table[h & mask]; entry.key == h && entry.depth >= d)
-                return entry;
+            Bucket& bucket = bucket_for(h);
+            const uint16_t key = key_of(h);
+            const uint8_t current = current_generation();
+
+            for (auto& slot : bucket.entries) {
+                const uint64_t e = slot.load(std::memory_order_relaxed);
+                if (bound_bits(e) == 0 || key_bits(e) != key)
+                    continue;
+
+                // Refresh the generation so entries still in use survive aging
+                if (generation_bits(e) != current) {
+                    const uint64_t refreshed = (e & ~(0x3FULL << 56)) | (uint64_t)current << 56;
+                    slot.store(refreshed, std::memory_order_relaxed);
+                }
+
+                if (depth_bits(e) < d)
+                    return std::nullopt;
+                return TTEntry{h, score_bits(e), depth_bits(e), (Flag)(bound_bits(e) - 1),
+                               Move::from_compact(move_bits(e))};
+            }
             return std::nullopt;
         }
 
+        /// Not thread-safe: call only while no search is running
         void resize(const size_t mb_size) {
-            size_t entry_count = (mb_size * 1024 * 1024) / sizeof(TTEntry);
+            bucket_count = (mb_size * 1024 * 1024) / sizeof(Bucket);
             // Round down to nearest power of 2
-            entry_count = 1LL << (63 - __builtin_clzll(entry_count));
-            table.resize(entry_count);
-            mask = entry_count - 1;
+            bucket_count = 1ULL << (63 - __builtin_clzll(bucket_count | 1));
+
+            memory = internal::LargePageBuffer();  // Release the old table before mapping the new one
+            memory = internal::LargePageBuffer(bucket_count * sizeof(Bucket));
+            table = static_cast<Bucket*>(memory.data());
+            mask = bucket_count - 1;
+            clear();
+        }
+
+        /// Not thread-safe: call only while no search is running
+        void clear() {
+            internal::parallel_clear(table, bucket_count * sizeof(Bucket));
+            generation.store(0, std::memory_order_relaxed);
         }
 
-        void clear() { std::ranges::fill(table, TTEntry{}); }
-        [[nodiscard]] size_t size_mb() const { return (table.size() * sizeof(TTEntry)) / (1024 * 1024); }
+        [[nodiscard]] size_t size_mb() const { return (bucket_count * sizeof(Bucket)) / (1024 * 1024); }
+
+        /// Per mille of entries written or used by the current search, from the first
+        /// thousand entries (UCI hashfull); the index is the hash, so they are a fair sample
+        [[nodiscard]] int hashfull() const {
+            const size_t buckets = std::min<size_t>(bucket_count, 1000 / BUCKET_SIZE);
+            const uint8_t current = current_generation();
+            int used = 0;
+            for (size_t i = 0; i < buckets; ++i)
+                for (const auto& slot : table[i].entries) {
+                    const uint64_t e = slot.load(std::memory_order_relaxed);
+                    used += bound_bits(e) != 0 && generation_bits(e) == current;
+                }
+            return (int)(used * 1000 / (buckets * BUCKET_SIZE));
+        }
     };
 
-}  // namespace chess
\ No newline at end of file
+}  // namespace chess
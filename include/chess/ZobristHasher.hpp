@@ -1,8 +1,8 @@
 #pragma once
 
 #include <array>
-#include <random>
 
+#include "Move.hpp"
 #include "types.hpp"
 
 namespace chess
@@ -11,39 +11,53 @@ namespace chess
         return (Piece)((int)color * 6 + (int)type);
     }
 
+    /// Zobrist keys, generated at compile time and shared by every Board
+    struct ZobristKeys {
+        std::array<std::array<Hash, 64>, 12> piece{};   // [piece][square]
+        std::array<Hash, 16> castle{};                  // [castle_rights]
+        std::array<Hash, 8> en_passant{};               // [en_passant_file] (no hash if none)
+        Hash black_move = 0;
+    };
+
+    /// SplitMix64 stream with a fixed seed, so keys are identical in every build and process
+    consteval ZobristKeys make_zobrist_keys() {
+        Hash state = 0x123456789ABCDEFULL;
+        const auto next = [&state] {
+            Hash z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        };
+
+        ZobristKeys keys;
+        for (auto& row : keys.piece) {
+            for (auto& h : row) h = next();
+        }
+        for (auto& h : keys.castle) h = next();
+        for (auto& h : keys.en_passant) h = next();
+        keys.black_move = next();
+        return keys;
+    }
+
+    inline constexpr ZobristKeys ZOBRIST = make_zobrist_keys();
+
+    /// Stateless hashing over the shared ZOBRIST keys
     class ZobristHasher {
     private:
-        std::array<std::array<Hash, 64>, 12> piece_hashes{};   // [piece][square]
-        std::array<Hash, 16> castle_hashes{};                  // [castle_rights]
-        std::array<Hash, 8> en_passant_hashes{};               // [en_passant_file] (no hash if none)
-        Hash black_move_hash;
+        static constexpr const auto& piece_hashes = ZOBRIST.piece;
+        static constexpr const auto& castle_hashes = ZOBRIST.castle;
+        static constexpr const auto& en_passant_hashes = ZOBRIST.en_passant;
+        static constexpr Hash black_move_hash = ZOBRIST.black_move;
 
     public:
-        ZobristHasher() {
-            // Initialize with pseudo-random values (seed with fixed constant)
-            std::mt19937_64 rng(0x123456789ABCDEFULL);
-            std::uniform_int_distribution<Hash> dist;
-
-            for (auto& row : piece_hashes) {
-                for (auto& h : row) h = dist(rng);
-            }
-            for (auto& h : castle_hashes) h = dist(rng);
-            for (auto& h : en_passant_hashes) h = dist(rng);
-            black_move_hash = dist(rng);
-        }
-
-        [[nodiscard]] Hash compute(const Position& pos) const {
+        [[nodiscard]] static Hash compute(const Position& pos) {
             Hash h = 0;
 
             // Hash pieces
             for (int color = 0; color < 2; ++color) {
                 for (int piece = 0; piece < 6; ++piece) {
-                    Bitboard bb = pos.pieces[color][piece];
-                    while (bb) {
-                        const int sq = bb & 1;
-                        h ^= piece_hashes[color * 6 + piece][sq];
-                        bb &= bb - 1;  // Clear LSB
-                    }
+                    for (const Square sq : Squares(pos.pieces[color][piece]))
+                        h ^= piece_hashes[color * 6 + piece][(int)sq];
                 }
             }
 
@@ -61,13 +75,48 @@ namespace chess
             return h;
         }
 
-        [[nodiscard]] Hash update(
+        /// Key over the pawns of both colors alone. Board keeps it current as pawns
+        /// are placed, moved and removed; the evaluator caches pawn structure under it
+        [[nodiscard]] static Hash compute_pawns(const Position& pos) {
+            Hash h = 0;
+            for (int color = 0; color < 2; ++color) {
+                for (const Square sq : Squares(pos.pieces[color][(int)PieceType::PAWN]))
+                    h ^= piece_hashes[color * 6 + (int)PieceType::PAWN][(int)sq];
+            }
+            return h;
+        }
+
+        /// Pawn key change for a pawn of `color` appearing on or leaving `sq`
+        [[nodiscard]] static Hash pawn_key(const Color color, const Square sq) {
+            return piece_hashes[(int)color * 6 + (int)PieceType::PAWN][(int)sq];
+        }
+
+        [[nodiscard]] static Hash update(
+            const Hash h,
+            const Move& move,
+            const Piece moved_piece, const Piece captured_piece,
+            const uint8_t old_castle_rights, const uint8_t new_castle_rights,
+            const Square old_en_passant, const Square new_en_passant
+        ) {
+            return get_piece_color(moved_piece) == Color::WHITE
+                ? update<Color::WHITE>(h, move, moved_piece, captured_piece, old_castle_rights, new_castle_rights,
+                                       old_en_passant, new_en_passant)
+                : update<Color::BLACK>(h, move, moved_piece, captured_piece, old_castle_rights, new_castle_rights,
+                                       old_en_passant, new_en_passant);
+        }
+
+        /// update() for a move by `Us`, with the en passant and castling squares as constants
+        template<Color Us>
+        [[nodiscard]] static Hash update(
             Hash h,
             const Move& move,
             const Piece moved_piece, const Piece captured_piece,
             const uint8_t old_castle_rights, const uint8_t new_castle_rights,
             const Square old_en_passant, const Square new_en_passant
-        ) const {
+        ) {
+            constexpr bool white = Us == Color::WHITE;
+            constexpr Color them = white ? Color::BLACK : Color::WHITE;
+
             // Remove piece from source
             h ^= piece_hashes[(int)moved_piece][(int)move.from()];
 
@@ -79,45 +128,29 @@ namespace chess
                 h ^= piece_hashes[(int)captured_piece][(int)move.to()];
             }
 
-            // Handle promotion
+            // Handle promotion: the pawn leaves the board, the promoted piece takes its square
             if (move.flag() == MoveFlag::PROMOTION) {
-                Piece promoted = make_piece(get_piece_color(moved_piece), move.promotion());
+                const Piece promoted = make_piece(Us, move.promotion());
+                h ^= piece_hashes[(int)moved_piece][(int)move.to()];
                 h ^= piece_hashes[(int)promoted][(int)move.to()];
             }
 
-            // Handle en passant capture
+            // Handle en passant capture: the captured pawn is one rank back
             if (move.flag() == MoveFlag::EN_PASSANT) {
-                Piece captured_pawn = make_piece(
-                    (get_piece_color(moved_piece) == Color::WHITE) ? Color::BLACK : Color::WHITE,
-                    PieceType::PAWN
-                );
-                auto captured_sq = (Square)((int)move.to() - 8);  // One rank back
-                if (get_piece_color(moved_piece) == Color::BLACK)
-                    captured_sq = (Square)((int)move.to() + 8);
-                h ^= piece_hashes[(int)captured_pawn][(int)captured_sq];
+                constexpr int pawn = (int)them * 6 + (int)PieceType::PAWN;
+                h ^= piece_hashes[pawn][(int)move.to() + (white ? -8 : 8)];
             }
 
-            // Handle castling rook movement
+            // Handle castling rook movement: the rook lands on the square the king crossed
             if (move.flag() == MoveFlag::CASTLING) {
-                Piece rook = make_piece(get_piece_color(moved_piece), PieceType::ROOK);
-
-                Square rook_from, rook_to;
-                if (move.to() == Square::G1) {
-                    rook_from = Square::H1;
-                    rook_to = Square::F1;
-                } else if (move.to() == Square::C1) {
-                    rook_from = Square::A1;
-                    rook_to = Square::D1;
-                } else if (move.to() == Square::G8) {
-                    rook_from = Square::H8;
-                    rook_to = Square::F8;
-                } else {
-                    rook_from = Square::A8;
-                    rook_to = Square::D8;
-                }
-
-                h ^= piece_hashes[(int)rook][(int)rook_from];
-                h ^= piece_hashes[(int)rook][(int)rook_to];
+                constexpr int rook = (int)Us * 6 + (int)PieceType::ROOK;
+                constexpr Square kingside_to = white ? Square::G1 : Square::G8;
+                const bool kingside = move.to() == kingside_to;
+                const Square rook_from = kingside ? (white ? Square::H1 : Square::H8) : (white ? Square::A1 : Square::A8);
+                const Square rook_to = kingside ? (white ? Square::F1 : Square::F8) : (white ? Square::D1 : Square::D8);
+
+                h ^= piece_hashes[rook][(int)rook_from];
+                h ^= piece_hashes[rook][(int)rook_to];
             }
 
             // Update castle rights
@@ -139,6 +172,13 @@ namespace chess
 
             return h;
         }
+
+        /// Hash after passing the move: side to move flips and any en passant square lapses
+        [[nodiscard]] static Hash update_null(Hash h, const Square old_en_passant) {
+            if (old_en_passant != Square::INVALID)
+                h ^= en_passant_hashes[(int)old_en_passant % 8];
+            return h ^ black_move_hash;
+        }
     };
 
 }
\ No newline at end of file
@@ -2,6 +2,10 @@
 
 #include <cassert>
 
+#if defined(CHESS_USE_PEXT)
+#include <immintrin.h>
+#endif
+
 #include "chess/types.hpp"
 
 namespace chess::internal {
@@ -49,80 +53,37 @@ namespace chess::internal {
         return idx;
     }
 
-    [[nodiscard]] inline Bitboard rook_attacks(Square sq, Bitboard occupancy) {
-        Bitboard attacks = 0;
-
-        const int s = static_cast<int>(sq);
-        const int file = s & 7;
-        const int rank = s >> 3;
-
-        // North
-        for (int r = rank + 1; r < 8; ++r) {
-            const int t = file + (r << 3);
-            attacks |= 1ULL << t;
-            if (occupancy & (1ULL << t)) break;
-        }
-
-        // South
-        for (int r = rank - 1; r >= 0; --r) {
-            const int t = file + (r << 3);
-            attacks |= 1ULL << t;
-            if (occupancy & (1ULL << t)) break;
+    /// Magic bitboard entry for one square of one slider type.
+    /// The attack set for an occupancy is found at attacks[index(occupancy)].
+    struct Magic {
+        Bitboard mask;       // Relevant occupancy (ray squares, edges excluded)
+        Bitboard magic;      // Multiplier mapping masked occupancy to a dense index
+        Bitboard* attacks;   // Slice of the shared attack table for this square
+        unsigned shift;      // 64 - popcount(mask)
+
+        [[nodiscard]] unsigned index(const Bitboard occupancy) const {
+#if defined(CHESS_USE_PEXT)
+            return static_cast<unsigned>(_pext_u64(occupancy, mask));
+#else
+            return static_cast<unsigned>(((occupancy & mask) * magic) >> shift);
+#endif
         }
+    };
 
-        // East
-        for (int f = file + 1; f < 8; ++f) {
-            const int t = f + (rank << 3);
-            attacks |= 1ULL << t;
-            if (occupancy & (1ULL << t)) break;
-        }
-
-        // West
-        for (int f = file - 1; f >= 0; --f) {
-            const int t = f + (rank << 3);
-            attacks |= 1ULL << t;
-            if (occupancy & (1ULL << t)) break;
-        }
+    // Pre-computed magic entries and attack tables (sliding pieces)
+    inline Magic ROOK_MAGICS[64] = {};
+    inline Magic BISHOP_MAGICS[64] = {};
+    inline Bitboard ROOK_TABLE[0x19000] = {};    // Sum of 2^bits over all squares
+    inline Bitboard BISHOP_TABLE[0x1480] = {};
 
-        return attacks;
+    [[nodiscard]] inline Bitboard rook_attacks(const Square sq, const Bitboard occupancy) {
+        const Magic& m = ROOK_MAGICS[(int)sq];
+        return m.attacks[m.index(occupancy)];
     }
 
-    [[nodiscard]] inline Bitboard bishop_attacks(Square sq, Bitboard occupancy) {
-        Bitboard attacks = 0;
-
-        const int s = static_cast<int>(sq);
-        const int file = s & 7;
-        const int rank = s >> 3;
-
-        // NE
-        for (int f = file + 1, r = rank + 1; f < 8 && r < 8; ++f, ++r) {
-            const int t = f + (r << 3);
-            attacks |= 1ULL << t;
-            if (occupancy & (1ULL << t)) break;
-        }
-
-        // NW
-        for (int f = file - 1, r = rank + 1; f >= 0 && r < 8; --f, ++r) {
-            const int t = f + (r << 3);
-            attacks |= 1ULL << t;
-            if (occupancy & (1ULL << t)) break;
-        }
-
-        // SE
-        for (int f = file + 1, r = rank - 1; f < 8 && r >= 0; ++f, --r) {
-            const int t = f + (r << 3);
-            attacks |= 1ULL << t;
-            if (occupancy & (1ULL << t)) break;
-        }
-
-        // SW
-        for (int f = file - 1, r = rank - 1; f >= 0 && r >= 0; --f, --r) {
-            const int t = f + (r << 3);
-            attacks |= 1ULL << t;
-            if (occupancy & (1ULL << t)) break;
-        }
-
-        return attacks;
+    [[nodiscard]] inline Bitboard bishop_attacks(const Square sq, const Bitboard occupancy) {
+        const Magic& m = BISHOP_MAGICS[(int)sq];
+        return m.attacks[m.index(occupancy)];
     }
 
     /// Generate queen attacks (combination of rook and bishop)
@@ -135,6 +96,11 @@ namespace chess::internal {
     inline Bitboard KING_ATTACKS[64] = {};
     inline Bitboard PAWN_ATTACKS[2][64] = {};  // [color][square]
 
+    // Square-pair geometry, empty if the squares don't share a rank, file or diagonal
+    inline Bitboard BETWEEN[64][64] = {};  // Squares strictly between a and b
+    inline Bitboard LINE[64][64] = {};     // Full board-edge-to-edge line through a and b
+
+    /// Build the attack tables above. Runs once per process; later calls return immediately
     void init_attacks();
 
 }  // namespace chess::internal
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+
+namespace chess::internal {
+
+    /// Memory block for large tables (transposition table), aligned to a huge page.
+    /// On Linux the block is mmap'ed: explicit 2 MiB huge pages (MAP_HUGETLB) when the
+    /// system has them reserved, otherwise ordinary pages with madvise(MADV_HUGEPAGE)
+    /// so transparent huge pages can back it. Elsewhere it falls back to an aligned
+    /// heap allocation. Contents are unspecified: clear with parallel_clear, which
+    /// also decides which NUMA node each page is first touched on.
+    class LargePageBuffer {
+    private:
+        void* ptr = nullptr;
+        size_t bytes = 0;
+        bool mapped = false;
+
+        void release();
+
+    public:
+        static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+        LargePageBuffer() = default;
+        explicit LargePageBuffer(size_t size);
+        ~LargePageBuffer();
+
+        LargePageBuffer(LargePageBuffer&& other) noexcept;
+        LargePageBuffer& operator=(LargePageBuffer&& other) noexcept;
+        LargePageBuffer(const LargePageBuffer&) = delete;
+        LargePageBuffer& operator=(const LargePageBuffer&) = delete;
+
+        [[nodiscard]] void* data() const { return ptr; }
+        [[nodiscard]] size_t size() const { return bytes; }
+    };
+
+    /// Zero `bytes` at `ptr` using one thread per hardware thread (threads == 0) or
+    /// the given count. Each thread clears a contiguous slice, so under the kernel's
+    /// first-touch policy every slice's pages land on the NUMA node of the thread
+    /// that cleared it, spreading the table over all nodes.
+    void parallel_clear(void* ptr, size_t bytes, unsigned threads = 0);
+
+}  // namespace chess::internal
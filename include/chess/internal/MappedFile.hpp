@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace chess::internal {
+
+    /// Read-only view of a whole file (network weights, opening books).
+    /// On POSIX systems the file is mmap'ed, so the data is never copied onto the
+    /// heap and every process and engine mapping the same file shares its page
+    /// cache pages. Elsewhere the file is read into a heap buffer once.
+    class MappedFile {
+    private:
+        const std::byte* ptr = nullptr;
+        size_t bytes = 0;
+        std::unique_ptr<std::byte[]> fallback;
+
+        void release();
+
+    public:
+        MappedFile() = default;
+
+        /// @throws std::runtime_error if the file can't be opened or mapped
+        explicit MappedFile(const std::string& path);
+        ~MappedFile();
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        [[nodiscard]] const std::byte* data() const { return ptr; }
+        [[nodiscard]] size_t size() const { return bytes; }
+    };
+
+}  // namespace chess::internal
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX512BW__) || defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace chess::internal {
+
+    // ============================================================================
+    // int16 vector kernels for the NNUE accumulator and output layer.
+    // One implementation is compiled in, picked by the target flags (the Release
+    // build uses -march=native): AVX-512BW, AVX2, NEON, or the scalar fallback.
+    // Lengths must be multiples of SIMD_WIDTH; accumulators are 64-byte aligned,
+    // weight rows need not be.
+    // ============================================================================
+
+#if defined(__AVX512BW__)
+    inline constexpr const char* SIMD_NAME = "avx512";
+    inline constexpr size_t SIMD_WIDTH = 32;
+#elif defined(__AVX2__)
+    inline constexpr const char* SIMD_NAME = "avx2";
+    inline constexpr size_t SIMD_WIDTH = 16;
+#elif defined(__ARM_NEON)
+    inline constexpr const char* SIMD_NAME = "neon";
+    inline constexpr size_t SIMD_WIDTH = 8;
+#else
+    inline constexpr const char* SIMD_NAME = "scalar";
+    inline constexpr size_t SIMD_WIDTH = 1;
+#endif
+
+    /// dst = src + sum(add rows) - sum(sub rows), in one pass over each lane.
+    /// dst and src may be the same array
+    inline void add_sub_rows(int16_t* dst, const int16_t* src, const size_t n,
+                             const int16_t* const* add, const int add_count,
+                             const int16_t* const* sub, const int sub_count) {
+        for (size_t i = 0; i < n; i += SIMD_WIDTH) {
+#if defined(__AVX512BW__)
+            __m512i v = _mm512_load_si512(src + i);
+            for (int k = 0; k < add_count; ++k) v = _mm512_add_epi16(v, _mm512_loadu_si512(add[k] + i));
+            for (int k = 0; k < sub_count; ++k) v = _mm512_sub_epi16(v, _mm512_loadu_si512(sub[k] + i));
+            _mm512_store_si512(dst + i, v);
+#elif defined(__AVX2__)
+            __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i*>(src + i));
+            for (int k = 0; k < add_count; ++k)
+                v = _mm256_add_epi16(v, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(add[k] + i)));
+            for (int k = 0; k < sub_count; ++k)
+                v = _mm256_sub_epi16(v, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sub[k] + i)));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(dst + i), v);
+#elif defined(__ARM_NEON)
+            int16x8_t v = vld1q_s16(src + i);
+            for (int k = 0; k < add_count; ++k) v = vaddq_s16(v, vld1q_s16(add[k] + i));
+            for (int k = 0; k < sub_count; ++k) v = vsubq_s16(v, vld1q_s16(sub[k] + i));
+            vst1q_s16(dst + i, v);
+#else
+            int v = src[i];
+            for (int k = 0; k < add_count; ++k) v += add[k][i];
+            for (int k = 0; k < sub_count; ++k) v -= sub[k][i];
+            dst[i] = (int16_t)v;
+#endif
+        }
+    }
+
+    /// sum(clamp(acc[i], 0, ceiling) * weights[i]), the clipped-ReLU output layer
+    [[nodiscard]] inline int32_t crelu_dot(const int16_t* acc, const int16_t* weights,
+                                           const size_t n, const int16_t ceiling) {
+#if defined(__AVX512BW__)
+        const __m512i zero = _mm512_setzero_si512();
+        const __m512i top = _mm512_set1_epi16(ceiling);
+        __m512i sum = _mm512_setzero_si512();
+        for (size_t i = 0; i < n; i += SIMD_WIDTH) {
+            const __m512i v = _mm512_min_epi16(_mm512_max_epi16(_mm512_load_si512(acc + i), zero), top);
+            sum = _mm512_add_epi32(sum, _mm512_madd_epi16(v, _mm512_loadu_si512(weights + i)));
+        }
+        // Once per eval, so a plain reduction: GCC 12's 512-to-256-bit casts (and
+        // _mm512_reduce_add_epi32 built on them) trip -Wuninitialized at -O3
+        alignas(64) int32_t lanes[16];
+        _mm512_store_si512(lanes, sum);
+        int32_t total = 0;
+        for (const int32_t lane : lanes) total += lane;
+        return total;
+#elif defined(__AVX2__)
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i top = _mm256_set1_epi16(ceiling);
+        __m256i sum = _mm256_setzero_si256();
+        for (size_t i = 0; i < n; i += SIMD_WIDTH) {
+            const __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(acc + i));
+            const __m256i v = _mm256_min_epi16(_mm256_max_epi16(a, zero), top);
+            const __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(v, w));
+        }
+        const __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        const __m128i quarter = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+        return _mm_cvtsi128_si32(_mm_add_epi32(quarter, _mm_shuffle_epi32(quarter, 0xB1)));
+#elif defined(__ARM_NEON)
+        const int16x8_t zero = vdupq_n_s16(0);
+        const int16x8_t top = vdupq_n_s16(ceiling);
+        int32x4_t sum = vdupq_n_s32(0);
+        for (size_t i = 0; i < n; i += SIMD_WIDTH) {
+            const int16x8_t v = vminq_s16(vmaxq_s16(vld1q_s16(acc + i), zero), top);
+            const int16x8_t w = vld1q_s16(weights + i);
+            sum = vmlal_s16(sum, vget_low_s16(v), vget_low_s16(w));
+            sum = vmlal_high_s16(sum, v, w);
+        }
+        return vaddvq_s32(sum);
+#else
+        int32_t sum = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const int v = acc[i] < 0 ? 0 : (acc[i] > ceiling ? ceiling : acc[i]);
+            sum += v * weights[i];
+        }
+        return sum;
+#endif
+    }
+
+}  // namespace chess::internal
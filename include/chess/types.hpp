@@ -2,7 +2,10 @@
 
 #include <array>
 #include <string>
+#include <string_view>
 #include <cstdint>
+#include <iterator>
+#include <type_traits>
 
 namespace chess {
     // Basic enumerations
@@ -34,6 +37,10 @@ namespace chess {
     using Score    = int32_t;   // Evaluation score in centipawns
 
     // Special score values
+    constexpr int MAX_DEPTH = 32;           // Deepest nominal search iteration
+    constexpr int MAX_PLY = 128;            // Deepest line the search can reach, quiescence included
+    constexpr int MAX_GAME_PLIES = 1024;    // Longest game history a Board keeps
+
     constexpr Score CHECKMATE = 32700;
     constexpr Score STALEMATE = 0;
     constexpr Score ILLEGAL_SCORE = -32768;
@@ -57,6 +64,9 @@ namespace chess {
         BLACK_QUEENSIDE = 8
     };
 
+    /// Complete board state as a plain value: everything a Board needs except the
+    /// move history. Obtain one with Board::position() and turn it back into a
+    /// Board with Board(const Position&) or Board::set_position().
     struct Position {
         // 12 bitboards: 6 piece types × 2 colors
         Bitboard pieces[2][6];  // [color][piece_type]
@@ -65,6 +75,9 @@ namespace chess {
         Bitboard occupancy[2];      // All pieces per color
         Bitboard occupancy_all;     // All pieces on board
 
+        // Square-to-piece lookup, kept in sync with the bitboards
+        Piece mailbox[64];          // Piece::NONE if empty
+
         // Game state
         Color side_to_move;
         uint8_t castle_rights;      // Bitmask (4 bits for 4 castling rights)
@@ -74,6 +87,49 @@ namespace chess {
 
         // Zobrist hash for transposition table lookups
         Hash zobrist_hash;
+        Hash pawn_hash;             // Pawns only, keys the evaluator's pawn structure cache
+
+        // Evaluation terms updated incrementally by make/unmake
+        Score psq_midgame;          // Material + midgame piece-square bonuses, white minus black
+        Score psq_endgame;          // Material + endgame piece-square bonuses, white minus black
+        Score material[2];          // Plain piece values per color
+        uint8_t phase;              // Non-pawn material weight, 24 with all pieces on the board
+    };
+
+    // Positions are passed between threads and restored in copy-make search by plain copies
+    static_assert(std::is_trivially_copyable_v<Position>);
+
+    /// Range over the set squares of a bitboard, lowest first.
+    /// Pops one bit per step, so iteration never allocates:
+    ///     for (const Square sq : Squares(bb)) { ... }
+    class Squares {
+    private:
+        Bitboard bb;
+
+    public:
+        class iterator {
+        private:
+            Bitboard bb;
+
+        public:
+            using value_type = Square;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() : bb(0) {}
+            explicit iterator(const Bitboard bb) : bb(bb) {}
+
+            Square operator*() const { return static_cast<Square>(__builtin_ctzll(bb)); }
+            iterator& operator++() { bb &= bb - 1; return *this; }
+            iterator operator++(int) { const iterator it = *this; ++*this; return it; }
+            bool operator==(std::default_sentinel_t) const { return bb == 0; }
+        };
+
+        explicit Squares(const Bitboard bb) : bb(bb) {}
+
+        [[nodiscard]] iterator begin() const { return iterator(bb); }
+        [[nodiscard]] std::default_sentinel_t end() const { return {}; }
+        [[nodiscard]] bool empty() const { return bb == 0; }
+        [[nodiscard]] int size() const { return __builtin_popcountll(bb); }
     };
 
     // Utility functions for Square
@@ -86,9 +142,9 @@ namespace chess {
     inline int mate_distance(const Score s) { return (CHECKMATE - std::abs(s)) / 2;}
 
     std::string square_to_string(Square sq);
-    Square string_to_square(const std::string& s);
+    Square string_to_square(std::string_view s);
     char piece_to_char(Piece p);
-    PieceType get_piece_type(Piece p);
-    Color get_piece_color(Piece p);
+    constexpr PieceType get_piece_type(const Piece p) { return (PieceType)((int)p % 6); }
+    constexpr Color get_piece_color(const Piece p) { return (Color)((int)p / 6); }
 
 }  // namespace chess
@@ -0,0 +1,325 @@
+#include "chess/BatchAnalyzer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "chess/Board.hpp"
+#include "chess/EpdReader.hpp"
+#include "chess/TranspositionTable.hpp"
+
+namespace chess
+{
+    namespace
+    {
+        struct Task {
+            size_t index;
+            BatchJob job;
+            std::string error;  // Set when the input line couldn't be parsed
+        };
+
+        struct Worker {
+            std::unique_ptr<Engine> engine;
+            std::mutex mutex;           // Guards queue: the owner pops the front, thieves the back
+            std::deque<Task> queue;
+            std::thread thread;
+        };
+
+        std::string trim(const std::string& s) {
+            const size_t first = s.find_first_not_of(" \t\r\n");
+            if (first == std::string::npos) return {};
+            return s.substr(first, s.find_last_not_of(" \t\r\n") - first + 1);
+        }
+
+        template<typename T>
+        T parse_operand(const std::string_view operand, const std::string_view opcode) {
+            T value {};
+            const auto [end, error] = std::from_chars(operand.data(), operand.data() + operand.size(), value);
+            if (error != std::errc() || end != operand.data() + operand.size())
+                throw std::invalid_argument("Bad EPD " + std::string(opcode) + " operand: " + std::string(operand));
+            return value;
+        }
+    }
+
+    // ============================================================================
+    // BatchAnalyzer::Impl
+    // ============================================================================
+
+    class BatchAnalyzer::Impl {
+    public:
+        BatchConfig config;
+        std::vector<std::unique_ptr<Worker>> workers;
+        size_t capacity;
+
+        explicit Impl(const BatchConfig& cfg);
+        ~Impl();
+
+        /// Feed tasks from `next` until it runs out, then wait for the pool to drain
+        size_t run(const std::function<std::optional<Task>()>& next, const Callback& on_result);
+
+    private:
+        // Guards the counters and flags below: the feeder waits on space_cv for
+        // in_flight to drop, idle workers on work_cv for queued to rise
+        std::mutex state_mutex;
+        std::condition_variable work_cv;
+        std::condition_variable space_cv;
+        size_t queued = 0;          // Tasks sitting in some worker's queue
+        size_t in_flight = 0;       // Tasks fed and not yet finished
+        bool shutting_down = false;
+
+        // One result at a time goes to the callback
+        std::mutex callback_mutex;
+        const Callback* callback = nullptr;
+        size_t delivered = 0;
+        std::exception_ptr failure;
+        std::atomic<bool> cancelled = false;
+
+        void work(size_t id);
+        std::optional<Task> take(size_t id);
+        BatchResult analyze(const Engine& engine, const Task& task) const;
+        void finish_task();
+    };
+
+    BatchAnalyzer::Impl::Impl(const BatchConfig& cfg) : config(cfg) {
+        const int count = cfg.workers > 0 ? cfg.workers : (int)std::max(1u, std::thread::hardware_concurrency());
+        capacity = cfg.max_pending > 0 ? cfg.max_pending : 4 * (size_t)count;
+
+        std::shared_ptr<TranspositionTable> shared;
+        if (cfg.share_tt)
+            shared = std::make_shared<TranspositionTable>(cfg.search.tt_size_mb);
+
+        for (int id = 0; id < count; ++id) {
+            auto& worker = workers.emplace_back(std::make_unique<Worker>());
+            worker->engine = shared ? std::make_unique<Engine>(cfg.search, shared)
+                                    : std::make_unique<Engine>(cfg.search);
+            if (cfg.network) worker->engine->set_network(cfg.network);
+        }
+        // Engines exist before any thread starts, so a failed allocation leaves nothing running
+        for (size_t id = 0; id < workers.size(); ++id)
+            workers[id]->thread = std::thread(&Impl::work, this, id);
+    }
+
+    BatchAnalyzer::Impl::~Impl() {
+        {
+            std::lock_guard lock(state_mutex);
+            shutting_down = true;
+        }
+        work_cv.notify_all();
+        for (const auto& worker : workers)
+            worker->thread.join();
+    }
+
+    size_t BatchAnalyzer::Impl::run(const std::function<std::optional<Task>()>& next, const Callback& on_result) {
+        callback = &on_result;
+        delivered = 0;
+        failure = nullptr;
+        cancelled = false;
+
+        std::exception_ptr feed_failure;
+        size_t target = 0;
+        try {
+            while (!cancelled) {
+                {
+                    std::unique_lock lock(state_mutex);
+                    space_cv.wait(lock, [this] { return in_flight < capacity || cancelled; });
+                }
+                if (cancelled) break;
+
+                std::optional<Task> task = next();
+                if (!task) break;
+
+                Worker& worker = *workers[target];
+                target = (target + 1) % workers.size();
+                {
+                    std::lock_guard lock(worker.mutex);
+                    worker.queue.push_back(std::move(*task));
+                }
+                {
+                    std::lock_guard lock(state_mutex);
+                    ++queued;
+                    ++in_flight;
+                }
+                work_cv.notify_one();
+            }
+        }
+        catch (...) {
+            // The input failed: stop starting jobs, but let the running ones finish
+            feed_failure = std::current_exception();
+            cancelled = true;
+        }
+
+        {
+            std::unique_lock lock(state_mutex);
+            space_cv.wait(lock, [this] { return in_flight == 0; });
+        }
+        callback = nullptr;
+
+        if (failure) std::rethrow_exception(failure);
+        if (feed_failure) std::rethrow_exception(feed_failure);
+        return delivered;
+    }
+
+    std::optional<Task> BatchAnalyzer::Impl::take(const size_t id) {
+        // Own queue first, oldest task; then the newest task of the next worker that has any
+        for (size_t k = 0; k < workers.size(); ++k) {
+            Worker& victim = *workers[(id + k) % workers.size()];
+            std::optional<Task> task;
+            {
+                std::lock_guard lock(victim.mutex);
+                if (victim.queue.empty()) continue;
+                if (k == 0) {
+                    task = std::move(victim.queue.front());
+                    victim.queue.pop_front();
+                } else {
+                    task = std::move(victim.queue.back());
+                    victim.queue.pop_back();
+                }
+            }
+            std::lock_guard lock(state_mutex);
+            --queued;
+            return task;
+        }
+        return std::nullopt;
+    }
+
+    void BatchAnalyzer::Impl::work(const size_t id) {
+        const Engine& engine = *workers[id]->engine;
+
+        for (;;) {
+            std::optional<Task> task = take(id);
+            if (!task) {
+                std::unique_lock lock(state_mutex);
+                work_cv.wait(lock, [this] { return shutting_down || queued > 0; });
+                if (shutting_down && queued == 0) return;
+                continue;
+            }
+
+            if (!cancelled) {
+                const BatchResult result = analyze(engine, *task);
+
+                std::lock_guard lock(callback_mutex);
+                if (!cancelled) {
+                    try {
+                        (*callback)(result);
+                        ++delivered;
+                    }
+                    catch (...) {
+                        failure = std::current_exception();
+                        cancelled = true;
+                    }
+                }
+            }
+            finish_task();
+        }
+    }
+
+    void BatchAnalyzer::Impl::finish_task() {
+        {
+            std::lock_guard lock(state_mutex);
+            --in_flight;
+        }
+        space_cv.notify_all();
+    }
+
+    BatchResult BatchAnalyzer::Impl::analyze(const Engine& engine, const Task& task) const {
+        BatchResult out = { task.index, task.job, {}, task.error };
+        if (!out.error.empty())
+            return out;
+
+        const BatchJob& job = task.job;
+        const bool own_budget = job.depth > 0 || job.nodes > 0;
+        const Depth depth = own_budget ? job.depth : config.depth;
+
+        SearchConfig search = config.search;
+        search.node_limit = own_budget ? job.nodes : config.nodes;
+        search.max_depth = depth > 0 ? std::min<int>(depth, MAX_DEPTH) : MAX_DEPTH;
+
+        try {
+            Board board;
+            board.load_fen(job.fen);
+            engine.set_config(search);
+            out.result = engine.find_best_move(board, (Depth)search.max_depth);
+        }
+        catch (const std::exception& e) {
+            out.error = e.what();
+        }
+        return out;
+    }
+
+    // ============================================================================
+    // BatchAnalyzer
+    // ============================================================================
+
+    BatchAnalyzer::BatchAnalyzer(const BatchConfig& config) : impl(std::make_unique<Impl>(config)) {}
+
+    BatchAnalyzer::~BatchAnalyzer() = default;
+
+    int BatchAnalyzer::worker_count() const
+    {
+        return (int)impl->workers.size();
+    }
+
+    size_t BatchAnalyzer::run(const std::span<const BatchJob> jobs, const Callback& on_result)
+    {
+        size_t next = 0;
+        return impl->run([&]() -> std::optional<Task> {
+            if (next == jobs.size()) return std::nullopt;
+            const size_t index = next++;
+            return Task{ index, jobs[index], {} };
+        }, on_result);
+    }
+
+    size_t BatchAnalyzer::run(std::istream& input, const Callback& on_result)
+    {
+        size_t index = 0;
+        return impl->run([&]() -> std::optional<Task> {
+            std::string line;
+            while (std::getline(input, line)) {
+                try {
+                    if (auto job = parse_line(line))
+                        return Task{ index++, std::move(*job), {} };
+                }
+                catch (const std::invalid_argument& e) {
+                    // Reported in its place rather than ending the run
+                    return Task{ index++, BatchJob{ trim(line), {}, 0, 0 }, e.what() };
+                }
+            }
+            return std::nullopt;
+        }, on_result);
+    }
+
+    std::optional<BatchJob> BatchAnalyzer::parse_line(const std::string& line)
+    {
+        EpdRecord record;
+        if (!EpdReader::parse(line, record))
+            return std::nullopt;
+
+        BatchJob job;
+        job.fen = record.fen;
+        if (const auto acd = record.operation("acd"))
+            job.depth = (Depth)std::min(parse_operand<int>(*acd, "acd"), MAX_DEPTH);
+        if (const auto acn = record.operation("acn"))
+            job.nodes = parse_operand<uint64_t>(*acn, "acn");
+        if (const auto id = record.operation("id"))
+            job.id = *id;
+
+        // Clocks from operations when the line didn't start as a full FEN
+        if (record.clocks.empty()) {
+            const auto hmvc = record.operation("hmvc");
+            const auto fmvn = record.operation("fmvn");
+            job.fen += ' ';
+            job.fen += std::to_string(hmvc ? parse_operand<int>(*hmvc, "hmvc") : 0);
+            job.fen += ' ';
+            job.fen += std::to_string(fmvn ? parse_operand<int>(*fmvn, "fmvn") : 1);
+        }
+        return job;
+    }
+
+}  // namespace chess
@@ -5,10 +5,14 @@
 #include "chess/Board.hpp"
 
 #include <algorithm>
+#include <cassert>
+#include <charconv>
 #include <ranges>
 #include <unordered_map>
 
 #include "chess/Move.hpp"
+#include "chess/Nnue.hpp"
+#include "chess/PieceSquareTables.hpp"
 #include "chess/ZobristHasher.hpp"
 #include "chess/internal/Bitboard.hpp"
 
@@ -20,7 +24,7 @@ namespace chess
     // Helper Functions (internal)
     // ============================================================================
 
-    Square string_to_square(const std::string& s) {
+    Square string_to_square(const std::string_view s) {
         if (s == "-") return Square::INVALID;
         if (s.length() != 2) throw std::invalid_argument("Invalid square");
 
@@ -42,6 +46,37 @@ namespace chess
         return std::string(1, (char)('a' + file)) + std::string(1, (char)('1' + rank));
     }
 
+    std::string Move::to_uci() const {
+        if (*this == Move()) return "0000";
+
+        std::string uci = square_to_string(from()) + square_to_string(to());
+        if (is_promotion())
+            uci += "pnbrqk"[(int)promotion()];
+        return uci;
+    }
+
+    Move Move::from_uci(const std::string& uci_str) {
+        if (uci_str.length() != 4 && uci_str.length() != 5)
+            throw std::invalid_argument("Invalid UCI move");
+
+        const Square from = string_to_square(uci_str.substr(0, 2));
+        const Square to = string_to_square(uci_str.substr(2, 2));
+        if (from == Square::INVALID || to == Square::INVALID)
+            throw std::invalid_argument("Invalid UCI move");
+
+        if (uci_str.length() == 4)
+            return {from, to};
+
+        // Capture/castling/en passant flags depend on the position; only promotions are encoded
+        switch (uci_str[4]) {
+            case 'n': return {from, to, MoveFlag::PROMOTION, PieceType::KNIGHT};
+            case 'b': return {from, to, MoveFlag::PROMOTION, PieceType::BISHOP};
+            case 'r': return {from, to, MoveFlag::PROMOTION, PieceType::ROOK};
+            case 'q': return {from, to, MoveFlag::PROMOTION, PieceType::QUEEN};
+            default: throw std::invalid_argument("Invalid UCI promotion");
+        }
+    }
+
     char piece_to_char(Piece p) {
         static constexpr char chars[] = "PNBRQKpnbrqk";
         return chars[(int)p];
@@ -51,6 +86,80 @@ namespace chess
     // Board::Impl (internal)
     // ============================================================================
 
+    /// Which subset of the legal moves a generator call produces.
+    /// CAPTURES and QUIETS partition ALL: captures, en passant and queen
+    /// promotions are tactical, everything else (including under-promotions) is quiet.
+    enum class GenType : uint8_t { ALL, CAPTURES, QUIETS };
+
+    constexpr Bitboard square_bb(const Square sq) { return 1ULL << (int)sq; }
+
+    /// One side's geometry as compile-time constants, for code specialized on the color
+    template<Color Us>
+    struct SideTraits {
+        static constexpr bool WHITE = Us == Color::WHITE;
+        static constexpr Color THEM = WHITE ? Color::BLACK : Color::WHITE;
+
+        static constexpr int PUSH = WHITE ? 8 : -8;         // Square offset of a pawn step
+        static constexpr int START_RANK = WHITE ? 1 : 6;
+        static constexpr int PROMOTION_RANK = WHITE ? 7 : 0;
+
+        static constexpr Square KING_HOME = WHITE ? Square::E1 : Square::E8;
+        static constexpr uint8_t KINGSIDE_RIGHT = WHITE ? 0b0001 : 0b0100;
+        static constexpr uint8_t QUEENSIDE_RIGHT = WHITE ? 0b0010 : 0b1000;
+        static constexpr Square KINGSIDE_VIA = WHITE ? Square::F1 : Square::F8;
+        static constexpr Square KINGSIDE_TO = WHITE ? Square::G1 : Square::G8;
+        static constexpr Square QUEENSIDE_VIA = WHITE ? Square::D1 : Square::D8;
+        static constexpr Square QUEENSIDE_TO = WHITE ? Square::C1 : Square::C8;
+        static constexpr Square KINGSIDE_ROOK = WHITE ? Square::H1 : Square::H8;
+        static constexpr Square QUEENSIDE_ROOK = WHITE ? Square::A1 : Square::A8;
+
+        // Squares between king and rook, which must be empty to castle
+        static constexpr Bitboard KINGSIDE_BETWEEN = square_bb(KINGSIDE_VIA) | square_bb(KINGSIDE_TO);
+        static constexpr Bitboard QUEENSIDE_BETWEEN = square_bb(QUEENSIDE_VIA) | square_bb(QUEENSIDE_TO) |
+                                                      square_bb(WHITE ? Square::B1 : Square::B8);
+    };
+
+    /// Exchange values for SEE: PIECE_VALUES, with the king priced above any exchange
+    constexpr int see_value(const PieceType type) {
+        return type == PieceType::KING ? 20000 : (int)PIECE_VALUES[(int)type];
+    }
+
+    /// Fixed-capacity undo stack: a whole game plus the deepest search line fit
+    /// without the search ever touching the allocator. Copies take only the used part.
+    class UndoStack {
+    private:
+        static constexpr size_t CAPACITY = MAX_GAME_PLIES + MAX_PLY;
+
+        std::array<MoveUndo, CAPACITY> entries;
+        size_t count = 0;
+
+    public:
+        UndoStack() = default;
+        UndoStack(const UndoStack& other) : count(other.count) {
+            std::copy_n(other.entries.begin(), count, entries.begin());
+        }
+        UndoStack& operator=(const UndoStack& other) {
+            count = other.count;
+            std::copy_n(other.entries.begin(), count, entries.begin());
+            return *this;
+        }
+
+        [[nodiscard]] bool full() const { return count == CAPACITY; }
+        [[nodiscard]] bool empty() const { return count == 0; }
+        [[nodiscard]] size_t size() const { return count; }
+
+        void push_back(const MoveUndo& undo) {
+            assert(!full());
+            entries[count++] = undo;
+        }
+        void pop_back() { --count; }
+        [[nodiscard]] const MoveUndo& back() const { return entries[count - 1]; }
+        void clear() { count = 0; }
+
+        [[nodiscard]] auto begin() const { return entries.begin(); }
+        [[nodiscard]] auto end() const { return entries.begin() + count; }
+    };
+
     class Board::Impl
     {
     public:
@@ -59,13 +168,19 @@ namespace chess
         Impl& operator=(const Impl& other) = default;
 
         Position position;
-        ZobristHasher hasher;
-        std::vector<MoveUndo> undo_history;
+        UndoStack undo_history;
+
+        // NNUE accumulators when a network is attached: entry i belongs to the
+        // position after the first i moves of undo_history, so make and unmake
+        // only move the index. The vector grows to the deepest ply seen and stays
+        std::shared_ptr<const NnueNetwork> network;
+        std::vector<nnue::Accumulator> accumulators;
+        nnue::DirtyPieces* dirty = nullptr;     // Set while apply_move records piece changes
 
         static constexpr std::string_view DEFAULT_BOARD = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR";
 
         void reset();
-        void parse_fen(const std::string& fen);
+        void parse_fen(std::string_view fen);
         [[nodiscard]] std::string position_to_fen() const;
         [[nodiscard]] std::string board_to_ascii() const;
         [[nodiscard]] Piece get_piece_at(Square sq) const;
@@ -73,28 +188,53 @@ namespace chess
         [[nodiscard]] std::vector<Square> pieces_of_type(Color color, PieceType type) const;
         [[nodiscard]] std::vector<Move> get_move_history() const;
 
-        void generate_pseudo_legal_moves(MoveList& moves) const;
-        void generate_pawn_moves(Color color, MoveList& moves) const;
-        void generate_knight_moves(Color color, MoveList& moves) const;
-        void generate_king_moves(Color color, MoveList& moves) const;
-        void generate_bishop_moves(Square sq, MoveList& moves) const;
-        void generate_rook_moves(Square sq, MoveList& moves) const;
-        void generate_queen_moves(Square sq, MoveList& moves) const;
-        void generate_castling_moves(Color color, MoveList& moves) const;
-
-        [[nodiscard]] bool is_square_attacked_by(Square sq, Color enemy_color) const;
+        // Move generation dispatches once on the side to move and the move subset;
+        // the templates below it have both, and everything derived from them, as constants
+        void generate_legal_moves(MoveList& moves, GenType type) const;
+        [[nodiscard]] bool has_legal_move() const;
+        [[nodiscard]] bool is_generated_move(Move move) const;
+        template<Color Us, GenType Type> void generate_legal(MoveList& moves) const;
+        template<Color Us> [[nodiscard]] bool has_legal_move() const;
+        template<Color Us> [[nodiscard]] bool is_generated_move(Move move) const;
+        template<Color Us, GenType Type>
+        void generate_pawn_moves(Square king, Bitboard evasions, Bitboard pinned, MoveList& moves) const;
+        template<Color Us, PieceType Pt>
+        void generate_piece_moves(Square king, Bitboard targets, Bitboard pinned, MoveList& moves) const;
+        template<Color Us> void generate_king_moves(Bitboard targets, MoveList& moves) const;
+        template<Color Us> void generate_castling_moves(MoveList& moves) const;
+        template<GenType Type> static void add_promotions(Square from, Square to, MoveList& moves);
+
+        template<PieceType Pt> [[nodiscard]] static Bitboard piece_attacks(Square sq, Bitboard occupancy);
+        [[nodiscard]] Bitboard attackers_to(Square sq, Bitboard occupancy) const;
+        template<Color Us> [[nodiscard]] Bitboard pinned_pieces(Square king) const;
+        template<Color Them> [[nodiscard]] bool is_square_attacked_by(Square sq) const;
         [[nodiscard]] bool is_king_under_attack(Color king_color) const;
 
+        [[nodiscard]] int see(Move move) const;
+        [[nodiscard]] bool see_ge(Move move, int threshold) const;
+        [[nodiscard]] PieceType least_valuable(Bitboard attackers, Color color, Square& from) const;
+
         [[nodiscard]] uint8_t calculate_new_castle_rights(Move move) const;
-        [[nodiscard]] Square calculate_new_en_passant(Move move);
+        // Make and unmake dispatch on the mover's color like the generators
         void apply_move(const Move& move);
         void restore_from_history();
+        template<Color Us> void apply_move(const Move& move, Piece piece);
+        template<Color Us> void restore_move(const MoveUndo& undo);
+        void apply_null_move();
+
+        // Board edits keeping bitboards, occupancy, mailbox and eval terms in sync
+        void put_piece(Piece piece, Square sq);
+        void remove_piece(Square sq);
+        void move_piece(Square from, Square to);
+
+        void push_accumulator();
+        void invalidate_accumulators();
+        template<Color Us> static void castling_rook_squares(Square king_to, Square& rook_from, Square& rook_to);
 
         [[nodiscard]] Square find_king(Color color) const;
-        void update_occupancy();
 
     private:
-        void parse_board(const std::string_view& board_str, Bitboard pieces[2][6]);
+        void parse_board(const std::string_view& board_str);
         [[nodiscard]] std::string board_to_fen() const;
         [[nodiscard]] std::string castle_rights_to_string(uint8_t castle_rights) const;
     };
@@ -110,372 +250,675 @@ namespace chess
         return moves;
     }
 
-    void Board::Impl::generate_pseudo_legal_moves(MoveList& moves) const {
+    void Board::Impl::generate_legal_moves(MoveList& moves, const GenType type) const {
+        // One dispatch per call: below it the side and the move subset are constants
+        const bool white = position.side_to_move == Color::WHITE;
+        switch (type) {
+        case GenType::ALL:      white ? generate_legal<Color::WHITE, GenType::ALL>(moves)
+                                      : generate_legal<Color::BLACK, GenType::ALL>(moves); break;
+        case GenType::CAPTURES: white ? generate_legal<Color::WHITE, GenType::CAPTURES>(moves)
+                                      : generate_legal<Color::BLACK, GenType::CAPTURES>(moves); break;
+        case GenType::QUIETS:   white ? generate_legal<Color::WHITE, GenType::QUIETS>(moves)
+                                      : generate_legal<Color::BLACK, GenType::QUIETS>(moves); break;
+        }
+    }
+
+    template<Color Us, GenType Type>
+    void Board::Impl::generate_legal(MoveList& moves) const {
+        using namespace internal;
+        using Side = SideTraits<Us>;
         moves.clear();
 
-        const Color player = position.side_to_move;
+        const Square king = find_king(Us);
 
-        // Generate for each piece type
-        generate_pawn_moves(player, moves);
-        generate_knight_moves(player, moves);
-        generate_king_moves(player, moves);
+        if (king == Square::INVALID)
+            throw std::invalid_argument("Invalid board: no king found");
 
-        for (const Square sq : pieces_of_type(player, PieceType::BISHOP))
-            generate_bishop_moves(sq, moves);
+        // Destination squares for pieces other than pawns (which handle promotions themselves)
+        Bitboard targets = ~position.occupancy[(int)Us];
+        if constexpr (Type == GenType::CAPTURES) targets = position.occupancy[(int)Side::THEM];
+        if constexpr (Type == GenType::QUIETS) targets = ~position.occupancy_all;
 
-        for (const Square sq : pieces_of_type(player, PieceType::ROOK))
-            generate_rook_moves(sq, moves);
+        const Bitboard checkers = attackers_to(king, position.occupancy_all) & position.occupancy[(int)Side::THEM];
 
-        for (const Square sq : pieces_of_type(player, PieceType::QUEEN))
-            generate_queen_moves(sq, moves);
-    }
+        // King moves are always possible; in double check they are the only option
+        generate_king_moves<Us>(targets, moves);
+        if (popcount(checkers) > 1) return;
 
-    void Board::Impl::generate_pawn_moves(Color color, MoveList& moves) const {
-        Bitboard pawns = position.pieces[(int)color][(int)PieceType::PAWN];
+        // In single check the other pieces must capture the checker or block its ray
+        const Bitboard evasions = checkers ? checkers | BETWEEN[(int)king][lsb(checkers)] : ~0ULL;
 
-        while (pawns) {
-            int sq = internal::lsb(pawns);
-            auto from = (Square)sq;
-
-            // Pawn single push
-            const int direction = (color == Color::WHITE) ? 8 : -8;
-            if (auto to = (Square)((int)from + direction); (int)to < 64 && get_piece_at(to) == Piece::NONE) {
-                // Check promotion
-                if (const int rank = (int)to / 8; (color == Color::WHITE && rank == 7) || (color == Color::BLACK && rank == 0)) {
-                    moves.add(Move(from, to, MoveFlag::PROMOTION, PieceType::QUEEN));
-                    moves.add(Move(from, to, MoveFlag::PROMOTION, PieceType::ROOK));
-                    moves.add(Move(from, to, MoveFlag::PROMOTION, PieceType::BISHOP));
-                    moves.add(Move(from, to, MoveFlag::PROMOTION, PieceType::KNIGHT));
-                } else {
-                    moves.add(Move(from, to, MoveFlag::NORMAL));
-                }
+        const Bitboard pinned = pinned_pieces<Us>(king);
 
-                // Double push from starting rank
-                if ((color == Color::WHITE && ((int)from / 8) == 1) ||
-                    (color == Color::BLACK && ((int)from / 8) == 6)) {
-                    if (const auto double_to = (Square)((int)from + 2 * direction); get_piece_at(double_to) == Piece::NONE) {
-                        moves.add(Move(from, double_to, MoveFlag::NORMAL));
-                    }
-                }
-            }
-
-            // Pawn captures
-            Bitboard attacks = internal::PAWN_ATTACKS[(int)color][(int)sq] & ~position.occupancy[(int)color];
-            while (attacks) {
-                int to_sq = internal::lsb(attacks);
-                auto to = (Square)to_sq;
-
-                if (const Piece target = get_piece_at(to); target != Piece::NONE && get_piece_color(target) != color) {
-                    // Check promotion capture
-                    if (const int rank = (int)to / 8; (color == Color::WHITE && rank == 7) || (color == Color::BLACK && rank == 0)) {
-                        moves.add(Move(from, to, MoveFlag::PROMOTION, PieceType::QUEEN));
-                        moves.add(Move(from, to, MoveFlag::PROMOTION, PieceType::ROOK));
-                        moves.add(Move(from, to, MoveFlag::PROMOTION, PieceType::BISHOP));
-                        moves.add(Move(from, to, MoveFlag::PROMOTION, PieceType::KNIGHT));
-                    } else {
-                        moves.add(Move(from, to, MoveFlag::CAPTURE));
-                    }
-                }
-
-                attacks &= attacks - 1;
-            }
+        generate_pawn_moves<Us, Type>(king, evasions, pinned, moves);
+        generate_piece_moves<Us, PieceType::KNIGHT>(king, targets & evasions, pinned, moves);
+        generate_piece_moves<Us, PieceType::BISHOP>(king, targets & evasions, pinned, moves);
+        generate_piece_moves<Us, PieceType::ROOK>(king, targets & evasions, pinned, moves);
+        generate_piece_moves<Us, PieceType::QUEEN>(king, targets & evasions, pinned, moves);
 
-            pawns &= pawns - 1;
-        }
+        if constexpr (Type != GenType::CAPTURES)
+            if (!checkers) generate_castling_moves<Us>(moves);
     }
 
-    void Board::Impl::generate_knight_moves(Color color, MoveList& moves) const {
-        Bitboard knights = position.pieces[(int)color][(int)PieceType::KNIGHT];
+    bool Board::Impl::has_legal_move() const {
+        return position.side_to_move == Color::WHITE ? has_legal_move<Color::WHITE>()
+                                                     : has_legal_move<Color::BLACK>();
+    }
 
-        while (knights) {
-            int sq = internal::lsb(knights);
-            const auto from = (Square)sq;
+    template<Color Us>
+    bool Board::Impl::has_legal_move() const {
+        using namespace internal;
+        using Side = SideTraits<Us>;
 
-            Bitboard attacks = internal::KNIGHT_ATTACKS[sq] & ~position.occupancy[(int)color];
-            while (attacks) {
-                int to_sq = internal::lsb(attacks);
-                const auto to = (Square)to_sq;
+        const Square king = find_king(Us);
 
-                if (const Piece target = get_piece_at(to); target == Piece::NONE) {
-                    moves.add(Move(from, to, MoveFlag::NORMAL));
-                } else if (get_piece_color(target) != color) {
-                    moves.add(Move(from, to, MoveFlag::CAPTURE));
-                }
+        if (king == Square::INVALID)
+            throw std::invalid_argument("Invalid board: no king found");
 
-                attacks &= attacks - 1;
-            }
+        const Bitboard targets = ~position.occupancy[(int)Us];
+        const Bitboard checkers = attackers_to(king, position.occupancy_all) & position.occupancy[(int)Side::THEM];
 
-            knights &= knights - 1;
-        }
+        // Same generators as generate_legal, stopping at the first piece type
+        // that has a move. Castling is skipped: it needs a legal king step anyway
+        MoveList moves;
+        generate_king_moves<Us>(targets, moves);
+        if (!moves.empty()) return true;
+        if (popcount(checkers) > 1) return false;
+
+        const Bitboard evasions = checkers ? checkers | BETWEEN[(int)king][lsb(checkers)] : ~0ULL;
+        const Bitboard pinned = pinned_pieces<Us>(king);
+
+        generate_piece_moves<Us, PieceType::KNIGHT>(king, targets & evasions, pinned, moves);
+        if (!moves.empty()) return true;
+        generate_piece_moves<Us, PieceType::BISHOP>(king, targets & evasions, pinned, moves);
+        if (!moves.empty()) return true;
+        generate_piece_moves<Us, PieceType::ROOK>(king, targets & evasions, pinned, moves);
+        if (!moves.empty()) return true;
+        generate_piece_moves<Us, PieceType::QUEEN>(king, targets & evasions, pinned, moves);
+        if (!moves.empty()) return true;
+
+        generate_pawn_moves<Us, GenType::ALL>(king, evasions, pinned, moves);
+        return !moves.empty();
     }
 
-    void Board::Impl::generate_king_moves(Color color, MoveList& moves) const {
-        const Bitboard kings = position.pieces[(int)color][(int)PieceType::KING];
+    bool Board::Impl::is_generated_move(const Move move) const {
+        return position.side_to_move == Color::WHITE ? is_generated_move<Color::WHITE>(move)
+                                                     : is_generated_move<Color::BLACK>(move);
+    }
 
-        if (kings == 0) return;  // No king (invalid position)
+    template<Color Us>
+    bool Board::Impl::is_generated_move(const Move move) const {
+        using namespace internal;
+        using Side = SideTraits<Us>;
 
-        int sq = internal::lsb(kings);
-        const auto from = (Square)sq;
+        const Piece piece = position.mailbox[(int)move.from()];
+        if (piece == Piece::NONE || get_piece_color(piece) != Us || move.from() == move.to())
+            return false;
 
-        Bitboard attacks = internal::KING_ATTACKS[sq] & ~position.occupancy[(int)color];
-        while (attacks) {
-            int to_sq = internal::lsb(attacks);
-            const auto to = (Square)to_sq;
+        const Square king = find_king(Us);
+        const Bitboard checkers = attackers_to(king, position.occupancy_all) & position.occupancy[(int)Side::THEM];
 
-            if (const Piece target = get_piece_at(to); target == Piece::NONE) {
-                moves.add(Move(from, to, MoveFlag::NORMAL));
-            } else if (get_piece_color(target) != color) {
-                moves.add(Move(from, to, MoveFlag::CAPTURE));
+        // Run only the moving piece's generator, aimed at the destination square
+        MoveList moves;
+        const Bitboard target = 1ULL << (int)move.to();
+        const PieceType type = get_piece_type(piece);
+        if (type == PieceType::KING) {
+            if (move.is_castling()) {
+                if (!checkers) generate_castling_moves<Us>(moves);
+            } else {
+                generate_king_moves<Us>(target & ~position.occupancy[(int)Us], moves);
+            }
+        } else if (popcount(checkers) <= 1) {
+            const Bitboard evasions = checkers ? checkers | BETWEEN[(int)king][lsb(checkers)] : ~0ULL;
+            const Bitboard pinned = pinned_pieces<Us>(king);
+            const Bitboard targets = target & evasions & ~position.occupancy[(int)Us];
+
+            switch (type) {
+            case PieceType::PAWN:   generate_pawn_moves<Us, GenType::ALL>(king, evasions, pinned, moves); break;
+            case PieceType::KNIGHT: generate_piece_moves<Us, PieceType::KNIGHT>(king, targets, pinned, moves); break;
+            case PieceType::BISHOP: generate_piece_moves<Us, PieceType::BISHOP>(king, targets, pinned, moves); break;
+            case PieceType::ROOK:   generate_piece_moves<Us, PieceType::ROOK>(king, targets, pinned, moves); break;
+            default:                generate_piece_moves<Us, PieceType::QUEEN>(king, targets, pinned, moves); break;
             }
-
-            attacks &= attacks - 1;
         }
 
-        generate_castling_moves(position.side_to_move, moves);
+        return std::ranges::find(moves, move) != moves.end();
     }
 
-    void Board::Impl::generate_castling_moves(const Color color, MoveList& moves) const {
-        // White castling
-        if (color == Color::WHITE) {
-            // Kingside castling (e1 to g1)
-            if ((position.castle_rights & 0b0001) != 0) {  // White kingside right exists
-                // Check if f1 and g1 are empty
-                if (get_piece_at(Square::F1) == Piece::NONE && get_piece_at(Square::G1) == Piece::NONE) {
-                    // Check if e1, f1, g1 are not under attack
-                    if (!is_square_attacked_by(Square::E1, Color::BLACK) &&
-                        !is_square_attacked_by(Square::F1, Color::BLACK) &&
-                        !is_square_attacked_by(Square::G1, Color::BLACK)) {
-                        moves.add(Move(Square::E1, Square::G1, MoveFlag::CASTLING));
-                    }
+    template<GenType Type>
+    void Board::Impl::add_promotions(const Square from, const Square to, MoveList& moves) {
+        // Queen promotions count as tactical moves, under-promotions as quiet ones
+        if constexpr (Type != GenType::QUIETS)
+            moves.add(Move(from, to, MoveFlag::PROMOTION, PieceType::QUEEN));
+        if constexpr (Type != GenType::CAPTURES) {
+            moves.add(Move(from, to, MoveFlag::PROMOTION, PieceType::ROOK));
+            moves.add(Move(from, to, MoveFlag::PROMOTION, PieceType::BISHOP));
+            moves.add(Move(from, to, MoveFlag::PROMOTION, PieceType::KNIGHT));
+        }
+    }
+
+    template<Color Us, GenType Type>
+    void Board::Impl::generate_pawn_moves(const Square king, const Bitboard evasions, const Bitboard pinned,
+                                          MoveList& moves) const {
+        using namespace internal;
+        using Side = SideTraits<Us>;
+
+        Bitboard pawns = position.pieces[(int)Us][(int)PieceType::PAWN];
+
+        while (pawns) {
+            const int sq = pop_lsb(pawns);
+            const auto from = (Square)sq;
+
+            // A pinned pawn may only move along the pin ray
+            Bitboard allowed = evasions;
+            if (get_bit(pinned, from))
+                allowed &= LINE[(int)king][sq];
+
+            // Pawn single push (the promotion rank is never a start square, so to stays on the board)
+            if (const auto to = (Square)(sq + Side::PUSH); !get_bit(position.occupancy_all, to)) {
+                if (get_bit(allowed, to)) {
+                    if (square_rank(to) == Side::PROMOTION_RANK)
+                        add_promotions<Type>(from, to, moves);
+                    else if constexpr (Type != GenType::CAPTURES)
+                        moves.add(Move(from, to, MoveFlag::NORMAL));
                 }
-            }
 
-            // Queenside castling (e1 to c1)
-            if ((position.castle_rights & 0b0010) != 0) {  // White queenside right exists
-                // Check if b1, c1, d1 are empty
-                if (get_piece_at(Square::B1) == Piece::NONE &&
-                    get_piece_at(Square::C1) == Piece::NONE &&
-                    get_piece_at(Square::D1) == Piece::NONE) {
-                    // Check if e1, d1, c1 are not under attack
-                    if (!is_square_attacked_by(Square::E1, Color::BLACK) &&
-                        !is_square_attacked_by(Square::D1, Color::BLACK) &&
-                        !is_square_attacked_by(Square::C1, Color::BLACK)) {
-                        moves.add(Move(Square::E1, Square::C1, MoveFlag::CASTLING));
+                // Double push from starting rank
+                if constexpr (Type != GenType::CAPTURES) {
+                    if (const auto double_to = (Square)(sq + 2 * Side::PUSH);
+                        square_rank(from) == Side::START_RANK &&
+                        !get_bit(position.occupancy_all, double_to) && get_bit(allowed, double_to)) {
+                        moves.add(Move(from, double_to, MoveFlag::NORMAL));
                     }
                 }
             }
-        }
 
-        // Black castling
-        if (color == Color::BLACK) {
-            // Kingside castling (e8 to g8)
-            if ((position.castle_rights & 0b0100) != 0) {  // Black kingside right exists
-                // Check if f8 and g8 are empty
-                if (get_piece_at(Square::F8) == Piece::NONE && get_piece_at(Square::G8) == Piece::NONE) {
-                    // Check if e8, f8, g8 are not under attack
-                    if (!is_square_attacked_by(Square::E8, Color::WHITE) &&
-                        !is_square_attacked_by(Square::F8, Color::WHITE) &&
-                        !is_square_attacked_by(Square::G8, Color::WHITE)) {
-                        moves.add(Move(Square::E8, Square::G8, MoveFlag::CASTLING));
-                    }
-                }
+            // Pawn captures (capture-promotions are split by promotion piece like pushes)
+            Bitboard attacks = PAWN_ATTACKS[(int)Us][sq] & position.occupancy[(int)Side::THEM] & allowed;
+            while (attacks) {
+                const auto to = (Square)pop_lsb(attacks);
+
+                if (square_rank(to) == Side::PROMOTION_RANK)
+                    add_promotions<Type>(from, to, moves);
+                else if constexpr (Type != GenType::QUIETS)
+                    moves.add(Move(from, to, MoveFlag::CAPTURE));
             }
 
-            // Queenside castling (e8 to c8)
-            if ((position.castle_rights & 0b1000) != 0) {  // Black queenside right exists
-                // Check if b8, c8, d8 are empty
-                if (get_piece_at(Square::B8) == Piece::NONE &&
-                    get_piece_at(Square::C8) == Piece::NONE &&
-                    get_piece_at(Square::D8) == Piece::NONE) {
-                    // Check if e8, d8, c8 are not under attack
-                    if (!is_square_attacked_by(Square::E8, Color::WHITE) &&
-                        !is_square_attacked_by(Square::D8, Color::WHITE) &&
-                        !is_square_attacked_by(Square::C8, Color::WHITE)) {
-                        moves.add(Move(Square::E8, Square::C8, MoveFlag::CASTLING));
-                    }
+            // En passant: removing two pawns from one rank can expose the king, so
+            // test the resulting occupancy directly instead of relying on pin masks
+            if constexpr (Type != GenType::QUIETS) {
+                if (const Square ep = position.en_passant_square;
+                    ep != Square::INVALID && get_bit(PAWN_ATTACKS[(int)Us][sq], ep)) {
+                    const auto captured_sq = (Square)((int)ep - Side::PUSH);
+                    const Bitboard occupancy = (position.occupancy_all ^ (1ULL << sq) ^ (1ULL << (int)captured_sq))
+                                             | (1ULL << (int)ep);
+                    const Bitboard attackers = attackers_to(king, occupancy) & position.occupancy[(int)Side::THEM]
+                                             & ~(1ULL << (int)captured_sq);
+                    if (!attackers)
+                        moves.add(Move(from, ep, MoveFlag::EN_PASSANT));
                 }
             }
         }
     }
 
-    void Board::Impl::generate_bishop_moves(const Square sq, MoveList& moves) const {
-        Bitboard attacks = internal::bishop_attacks(sq, position.occupancy_all) & ~position.occupancy[(int)position.side_to_move];
-        while (attacks) {
-            int to_sq = internal::lsb(attacks);
-            const auto to = (Square)to_sq;
+    template<Color Us, PieceType Pt>
+    void Board::Impl::generate_piece_moves(const Square king, const Bitboard targets, const Bitboard pinned,
+                                           MoveList& moves) const {
+        using namespace internal;
+        const Bitboard enemies = position.occupancy[(int)SideTraits<Us>::THEM];
 
-            if (const Piece target = get_piece_at(to); target == Piece::NONE) {
-                moves.add(Move(sq, to, MoveFlag::NORMAL));
-            } else if (get_piece_color(target) != position.side_to_move) {
-                moves.add(Move(sq, to, MoveFlag::CAPTURE));
-            }
+        Bitboard pieces = position.pieces[(int)Us][(int)Pt];
+
+        // Knights never survive a pin: no knight move stays on a line
+        if constexpr (Pt == PieceType::KNIGHT)
+            pieces &= ~pinned;
+
+        while (pieces) {
+            const int sq = pop_lsb(pieces);
+            const auto from = (Square)sq;
+
+            Bitboard attacks = piece_attacks<Pt>(from, position.occupancy_all) & targets;
+            if constexpr (Pt != PieceType::KNIGHT)
+                if (get_bit(pinned, from))
+                    attacks &= LINE[(int)king][sq];
 
-            attacks &= attacks - 1;
+            while (attacks) {
+                const auto to = (Square)pop_lsb(attacks);
+                moves.add(Move(from, to, get_bit(enemies, to) ? MoveFlag::CAPTURE : MoveFlag::NORMAL));
+            }
         }
     }
 
-    void Board::Impl::generate_rook_moves(const Square sq, MoveList& moves) const {
-        Bitboard attacks = internal::rook_attacks(sq, position.occupancy_all) & ~position.occupancy[(int)position.side_to_move];
+    template<Color Us>
+    void Board::Impl::generate_king_moves(const Bitboard targets, MoveList& moves) const {
+        using namespace internal;
+        const Bitboard kings = position.pieces[(int)Us][(int)PieceType::KING];
+        const Bitboard enemies = position.occupancy[(int)SideTraits<Us>::THEM];
+
+        if (kings == 0) return;  // No king (invalid position)
+
+        const int sq = lsb(kings);
+        const auto from = (Square)sq;
+
+        // Lift the king off the board so sliders checking it also cover the squares behind it
+        const Bitboard occupancy = position.occupancy_all ^ kings;
+
+        Bitboard attacks = KING_ATTACKS[sq] & targets;
         while (attacks) {
-            int to_sq = internal::lsb(attacks);
-            const auto to = (Square)to_sq;
+            const auto to = (Square)pop_lsb(attacks);
 
-            if (const Piece target = get_piece_at(to); target == Piece::NONE) {
-                moves.add(Move(sq, to, MoveFlag::NORMAL));
-            } else if (get_piece_color(target) != position.side_to_move) {
-                moves.add(Move(sq, to, MoveFlag::CAPTURE));
-            }
+            if (attackers_to(to, occupancy) & enemies)
+                continue;
 
-            attacks &= attacks - 1;
+            moves.add(Move(from, to, get_bit(enemies, to) ? MoveFlag::CAPTURE : MoveFlag::NORMAL));
         }
     }
 
-    void Board::Impl::generate_queen_moves(const Square sq, MoveList& moves) const {
-        Bitboard attacks = internal::queen_attacks(sq, position.occupancy_all) & ~position.occupancy[(int)position.side_to_move];
-        while (attacks) {
-            int to_sq = internal::lsb(attacks);
-            const auto to = (Square)to_sq;
-
-            if (const Piece target = get_piece_at(to); target == Piece::NONE) {
-                moves.add(Move(sq, to, MoveFlag::NORMAL));
-            } else if (get_piece_color(target) != position.side_to_move) {
-                moves.add(Move(sq, to, MoveFlag::CAPTURE));
+    template<Color Us>
+    void Board::Impl::generate_castling_moves(MoveList& moves) const {
+        using Side = SideTraits<Us>;
+
+        // The squares between king and rook must be empty, and the king may not
+        // castle out of, through or into check
+        const auto castle = [&](const uint8_t right, const Bitboard between, const Square via, const Square to) {
+            if ((position.castle_rights & right) && !(position.occupancy_all & between) &&
+                !is_square_attacked_by<Side::THEM>(Side::KING_HOME) &&
+                !is_square_attacked_by<Side::THEM>(via) &&
+                !is_square_attacked_by<Side::THEM>(to)) {
+                moves.add(Move(Side::KING_HOME, to, MoveFlag::CASTLING));
             }
+        };
+
+        castle(Side::KINGSIDE_RIGHT, Side::KINGSIDE_BETWEEN, Side::KINGSIDE_VIA, Side::KINGSIDE_TO);
+        castle(Side::QUEENSIDE_RIGHT, Side::QUEENSIDE_BETWEEN, Side::QUEENSIDE_VIA, Side::QUEENSIDE_TO);
+    }
+
+    template<PieceType Pt>
+    Bitboard Board::Impl::piece_attacks(const Square sq, const Bitboard occupancy) {
+        using namespace internal;
+        if constexpr (Pt == PieceType::KNIGHT) return KNIGHT_ATTACKS[(int)sq];
+        else if constexpr (Pt == PieceType::BISHOP) return bishop_attacks(sq, occupancy);
+        else if constexpr (Pt == PieceType::ROOK) return rook_attacks(sq, occupancy);
+        else if constexpr (Pt == PieceType::QUEEN) return queen_attacks(sq, occupancy);
+        else return KING_ATTACKS[(int)sq];
+    }
+
+    Bitboard Board::Impl::attackers_to(const Square sq, const Bitboard occupancy) const {
+        using namespace internal;
+        const auto& w = position.pieces[(int)Color::WHITE];
+        const auto& b = position.pieces[(int)Color::BLACK];
+
+        const Bitboard rooks   = w[(int)PieceType::ROOK]   | b[(int)PieceType::ROOK]   | w[(int)PieceType::QUEEN] | b[(int)PieceType::QUEEN];
+        const Bitboard bishops = w[(int)PieceType::BISHOP] | b[(int)PieceType::BISHOP] | w[(int)PieceType::QUEEN] | b[(int)PieceType::QUEEN];
+
+        return (PAWN_ATTACKS[(int)Color::BLACK][(int)sq] & w[(int)PieceType::PAWN])
+             | (PAWN_ATTACKS[(int)Color::WHITE][(int)sq] & b[(int)PieceType::PAWN])
+             | (KNIGHT_ATTACKS[(int)sq] & (w[(int)PieceType::KNIGHT] | b[(int)PieceType::KNIGHT]))
+             | (KING_ATTACKS[(int)sq]   & (w[(int)PieceType::KING]   | b[(int)PieceType::KING]))
+             | (rook_attacks(sq, occupancy) & rooks)
+             | (bishop_attacks(sq, occupancy) & bishops);
+    }
 
-            attacks &= attacks - 1;
+    template<Color Us>
+    Bitboard Board::Impl::pinned_pieces(const Square king) const {
+        using namespace internal;
+        const auto& enemy = position.pieces[(int)SideTraits<Us>::THEM];
+
+        // Enemy sliders that would see the king on an empty board
+        Bitboard snipers =
+            (rook_attacks(king, 0) & (enemy[(int)PieceType::ROOK] | enemy[(int)PieceType::QUEEN])) |
+            (bishop_attacks(king, 0) & (enemy[(int)PieceType::BISHOP] | enemy[(int)PieceType::QUEEN]));
+
+        Bitboard pinned = 0;
+        while (snipers) {
+            const int sniper = pop_lsb(snipers);
+            const Bitboard blockers = BETWEEN[(int)king][sniper] & position.occupancy_all;
+
+            if (popcount(blockers) == 1)
+                pinned |= blockers & position.occupancy[(int)Us];
         }
+
+        return pinned;
     }
 
-    bool Board::Impl::is_square_attacked_by(Square sq, Color enemy_color) const
+    template<Color Them>
+    bool Board::Impl::is_square_attacked_by(const Square sq) const
     {
         using namespace internal;
-        if (KNIGHT_ATTACKS[(int)sq] & position.pieces[(int)enemy_color][(int)PieceType::KNIGHT])
-            return true;
+        const auto& enemy = position.pieces[(int)Them];
 
-        if (KING_ATTACKS[(int)sq] & position.pieces[(int)enemy_color][(int)PieceType::KING])
+        if (KNIGHT_ATTACKS[(int)sq] & enemy[(int)PieceType::KNIGHT])
             return true;
 
-        if (PAWN_ATTACKS[(int)enemy_color][(int)sq] & position.pieces[(int)enemy_color][(int)PieceType::PAWN])
+        if (KING_ATTACKS[(int)sq] & enemy[(int)PieceType::KING])
             return true;
 
-        if (rook_attacks(sq, position.occupancy_all) & position.pieces[(int)enemy_color][(int)PieceType::ROOK])
+        // Squares a pawn of ours on sq would attack are the squares enemy pawns attack sq from
+        if (PAWN_ATTACKS[(int)SideTraits<Them>::THEM][(int)sq] & enemy[(int)PieceType::PAWN])
             return true;
 
-        if (bishop_attacks(sq, position.occupancy_all) & position.pieces[(int)enemy_color][(int)PieceType::BISHOP])
+        const Bitboard queens = enemy[(int)PieceType::QUEEN];
+        if (rook_attacks(sq, position.occupancy_all) & (enemy[(int)PieceType::ROOK] | queens))
             return true;
 
-        if (queen_attacks(sq, position.occupancy_all) & position.pieces[(int)enemy_color][(int)PieceType::QUEEN])
-                return true;
-
-        return false;
+        return (bishop_attacks(sq, position.occupancy_all) & (enemy[(int)PieceType::BISHOP] | queens)) != 0;
     }
 
     bool Board::Impl::is_king_under_attack(const Color king_color) const {
         const Square king = find_king(king_color);
-        const Color enemy_color = (king_color == Color::WHITE) ? Color::BLACK : Color::WHITE;
 
         if (king == Square::INVALID)
             throw std::invalid_argument("Invalid board: no king found");
 
-        return is_square_attacked_by(king, enemy_color);
+        return king_color == Color::WHITE ? is_square_attacked_by<Color::BLACK>(king)
+                                          : is_square_attacked_by<Color::WHITE>(king);
     }
 
-    uint8_t Board::Impl::calculate_new_castle_rights(const Move move) const {
-        const Square from = move.from();
+    // ============================================================================
+    // Static Exchange Evaluation
+    // ============================================================================
+
+    PieceType Board::Impl::least_valuable(const Bitboard attackers, const Color color, Square& from) const {
+        using namespace internal;
+        for (int pt = (int)PieceType::PAWN; pt <= (int)PieceType::KING; ++pt) {
+            if (const Bitboard bb = attackers & position.pieces[(int)color][pt]) {
+                from = (Square)lsb(bb);
+                return (PieceType)pt;
+            }
+        }
+        return PieceType::NONE;
+    }
+
+    int Board::Impl::see(const Move move) const {
+        using namespace internal;
+        if (move.is_castling()) return 0;
+
         const Square to = move.to();
-        if (move.flag() == MoveFlag::CASTLING) {
-            // If it's a castling move, we know the rights will be lost
-            if (from == Square::E1) return position.castle_rights & 0b1100;  // White loses both
-            if (from == Square::E8) return position.castle_rights & 0b0011;  // Black loses both
+        const auto& w = position.pieces[(int)Color::WHITE];
+        const auto& b = position.pieces[(int)Color::BLACK];
+        const Bitboard bishops = w[(int)PieceType::BISHOP] | b[(int)PieceType::BISHOP] | w[(int)PieceType::QUEEN] | b[(int)PieceType::QUEEN];
+        const Bitboard rooks   = w[(int)PieceType::ROOK]   | b[(int)PieceType::ROOK]   | w[(int)PieceType::QUEEN] | b[(int)PieceType::QUEEN];
+
+        // gain[d]: material balance for the side making capture d if the exchange stopped there
+        std::array<int, 32> gain{};
+        Bitboard occupancy = position.occupancy_all ^ (1ULL << (int)move.from());
+
+        if (move.is_en_passant()) {
+            gain[0] = see_value(PieceType::PAWN);
+            occupancy ^= 1ULL << ((int)to ^ 8);
+        } else if (const Piece victim = position.mailbox[(int)to]; victim != Piece::NONE) {
+            gain[0] = see_value(get_piece_type(victim));
+        }
+
+        // Value of whatever now stands on the target square
+        int on_square = see_value(get_piece_type(position.mailbox[(int)move.from()]));
+        if (move.is_promotion()) {
+            gain[0] += see_value(move.promotion()) - see_value(PieceType::PAWN);
+            on_square = see_value(move.promotion());
+        }
+
+        Bitboard attackers = attackers_to(to, occupancy) & occupancy;
+        Color side = (Color)((int)position.side_to_move ^ 1);
+        int d = 0;
+
+        while (d + 1 < (int)gain.size()) {
+            Square from;
+            const PieceType type = least_valuable(attackers & position.occupancy[(int)side], side, from);
+            if (type == PieceType::NONE) break;
+
+            // The king may only recapture when nothing defends the square any more
+            if (type == PieceType::KING && (attackers & position.occupancy[(int)side ^ 1])) break;
+
+            ++d;
+            gain[d] = on_square - gain[d - 1];
+            on_square = see_value(type);
+
+            // Removing the capturer may uncover a slider behind it (x-ray)
+            occupancy ^= 1ULL << (int)from;
+            if (type == PieceType::PAWN || type == PieceType::BISHOP || type == PieceType::QUEEN)
+                attackers |= bishop_attacks(to, occupancy) & bishops;
+            if (type == PieceType::ROOK || type == PieceType::QUEEN)
+                attackers |= rook_attacks(to, occupancy) & rooks;
+            attackers &= occupancy;
+
+            side = (Color)((int)side ^ 1);
         }
-        if (from == Square::H1 || to == Square::H1) return position.castle_rights & 0b1110;  // White kingside lost
-        if (from == Square::A1 || to == Square::A1) return position.castle_rights & 0b1101;  // White queenside lost
-        if (from == Square::H8 || to == Square::H8) return position.castle_rights & 0b1011;  // Black kingside lost
-        if (from == Square::A8 || to == Square::A8) return position.castle_rights & 0b0111;  // Black queenside lost
 
-        return position.castle_rights;  // No change
+        // Each side may decline to continue the exchange
+        while (d > 0) {
+            gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
+            --d;
+        }
+        return gain[0];
     }
 
-    Square Board::Impl::calculate_new_en_passant(const Move move) {
-        const Piece piece = get_piece_at(move.from());
-        if (get_piece_type(piece) != PieceType::PAWN)
-            return Square::INVALID;
+    bool Board::Impl::see_ge(const Move move, const int threshold) const {
+        using namespace internal;
+        if (move.is_castling()) return threshold <= 0;
+
+        const Square to = move.to();
+        const auto& w = position.pieces[(int)Color::WHITE];
+        const auto& b = position.pieces[(int)Color::BLACK];
+        const Bitboard bishops = w[(int)PieceType::BISHOP] | b[(int)PieceType::BISHOP] | w[(int)PieceType::QUEEN] | b[(int)PieceType::QUEEN];
+        const Bitboard rooks   = w[(int)PieceType::ROOK]   | b[(int)PieceType::ROOK]   | w[(int)PieceType::QUEEN] | b[(int)PieceType::QUEEN];
+
+        Bitboard occupancy = position.occupancy_all ^ (1ULL << (int)move.from());
+        int captured = 0;
+        if (move.is_en_passant()) {
+            captured = see_value(PieceType::PAWN);
+            occupancy ^= 1ULL << ((int)to ^ 8);
+        } else if (const Piece victim = position.mailbox[(int)to]; victim != Piece::NONE) {
+            captured = see_value(get_piece_type(victim));
+        }
+
+        int on_square = see_value(get_piece_type(position.mailbox[(int)move.from()]));
+        if (move.is_promotion()) {
+            captured += see_value(move.promotion()) - see_value(PieceType::PAWN);
+            on_square = see_value(move.promotion());
+        }
+
+        // swap is how far the side to move is above the threshold, negated each turn
+        int swap = captured - threshold;
+        if (swap < 0) return false;         // Even a free capture falls short
+
+        swap = on_square - swap;
+        if (swap <= 0) return true;         // Losing the capturer still meets the threshold
 
-        const int from_rank = (int)move.from() / 8;
-        const int to_rank = (int)move.to() / 8;
+        Bitboard attackers = attackers_to(to, occupancy) & occupancy;
+        Color side = position.side_to_move;
+        bool result = true;
 
-        if (std::abs(from_rank - to_rank) == 2) {  // Pawn moved 2 squares
-            // En passant square is the square between from and to
-            return (Square)(((int)move.from() + (int)move.to()) / 2);
+        while (true) {
+            side = (Color)((int)side ^ 1);
+            attackers &= occupancy;
+
+            Square from;
+            const PieceType type = least_valuable(attackers & position.occupancy[(int)side], side, from);
+            if (type == PieceType::NONE) break;
+
+            // A king recapture only stands if the other side has nothing left to hit it with
+            if (type == PieceType::KING)
+                return (attackers & position.occupancy[(int)side ^ 1]) ? result : !result;
+
+            result = !result;
+            swap = see_value(type) - swap;
+            if (swap < (int)result) break;
+
+            occupancy ^= 1ULL << (int)from;
+            if (type == PieceType::PAWN || type == PieceType::BISHOP || type == PieceType::QUEEN)
+                attackers |= bishop_attacks(to, occupancy) & bishops;
+            if (type == PieceType::ROOK || type == PieceType::QUEEN)
+                attackers |= rook_attacks(to, occupancy) & rooks;
         }
 
-        return Square::INVALID;
+        return result;
+    }
+
+    uint8_t Board::Impl::calculate_new_castle_rights(const Move move) const {
+        // Rights lost when a move leaves or lands on the king or rook home squares.
+        // Applied for both squares so e.g. a rook capturing a rook clears both sides.
+        auto rights_kept = [](const Square sq) -> uint8_t {
+            switch (sq) {
+            case Square::E1: return 0b1100;  // White loses both
+            case Square::H1: return 0b1110;  // White kingside lost
+            case Square::A1: return 0b1101;  // White queenside lost
+            case Square::E8: return 0b0011;  // Black loses both
+            case Square::H8: return 0b1011;  // Black kingside lost
+            case Square::A8: return 0b0111;  // Black queenside lost
+            default:         return 0b1111;
+            }
+        };
+
+        return position.castle_rights & rights_kept(move.from()) & rights_kept(move.to());
+    }
+
+    void Board::Impl::put_piece(const Piece piece, const Square sq) {
+        // Callers bound the square: parse_board throws on one off the board
+        assert((int)sq < 64);
+        const Bitboard bb = 1ULL << (int)sq;
+        const int color = (int)get_piece_color(piece);
+        const int type = (int)get_piece_type(piece);
+
+        position.pieces[color][type] |= bb;
+        position.occupancy[color] |= bb;
+        position.occupancy_all |= bb;
+        position.mailbox[(int)sq] = piece;
+        if (dirty) dirty->push(piece, Square::INVALID, sq);
+
+        position.psq_midgame += psq_midgame(piece, sq);
+        position.psq_endgame += psq_endgame(piece, sq);
+        position.material[color] += (Score)PIECE_VALUES[type];
+        position.phase += PHASE_WEIGHTS[type];
+        if (type == (int)PieceType::PAWN)
+            position.pawn_hash ^= ZobristHasher::pawn_key((Color)color, sq);
+    }
+
+    void Board::Impl::remove_piece(const Square sq) {
+        const Bitboard bb = 1ULL << (int)sq;
+        const Piece piece = position.mailbox[(int)sq];
+        const int color = (int)get_piece_color(piece);
+        const int type = (int)get_piece_type(piece);
+
+        position.pieces[color][type] ^= bb;
+        position.occupancy[color] ^= bb;
+        position.occupancy_all ^= bb;
+        position.mailbox[(int)sq] = Piece::NONE;
+        if (dirty) dirty->push(piece, sq, Square::INVALID);
+
+        position.psq_midgame -= psq_midgame(piece, sq);
+        position.psq_endgame -= psq_endgame(piece, sq);
+        position.material[color] -= (Score)PIECE_VALUES[type];
+        position.phase -= PHASE_WEIGHTS[type];
+        if (type == (int)PieceType::PAWN)
+            position.pawn_hash ^= ZobristHasher::pawn_key((Color)color, sq);
+    }
+
+    void Board::Impl::move_piece(const Square from, const Square to) {
+        const Bitboard from_to = (1ULL << (int)from) | (1ULL << (int)to);
+        const Piece piece = position.mailbox[(int)from];
+        const int color = (int)get_piece_color(piece);
+        const PieceType type = get_piece_type(piece);
+
+        position.pieces[color][(int)type] ^= from_to;
+        position.occupancy[color] ^= from_to;
+        position.occupancy_all ^= from_to;
+        position.mailbox[(int)from] = Piece::NONE;
+        position.mailbox[(int)to] = piece;
+        if (dirty) dirty->push(piece, from, to);
+
+        position.psq_midgame += psq_midgame(piece, to) - psq_midgame(piece, from);
+        position.psq_endgame += psq_endgame(piece, to) - psq_endgame(piece, from);
+        if (type == PieceType::PAWN)
+            position.pawn_hash ^= ZobristHasher::pawn_key((Color)color, from) ^
+                                  ZobristHasher::pawn_key((Color)color, to);
+    }
+
+    void Board::Impl::push_accumulator() {
+        if (!network) return;
+
+        // Called after the undo entry is pushed: the new position's slot
+        const size_t ply = undo_history.size();
+        if (ply >= accumulators.size())
+            accumulators.resize(ply + 1);
+
+        nnue::Accumulator& acc = accumulators[ply];
+        acc.computed[0] = acc.computed[1] = false;
+        acc.dirty.count = 0;
+        dirty = &acc.dirty;
+    }
+
+    void Board::Impl::invalidate_accumulators() {
+        // The position no longer follows from the recorded piece changes; every
+        // slot up to the current ply is rebuilt from the board when next needed
+        if (!network) return;
+
+        accumulators.resize(std::max(accumulators.size(), undo_history.size() + 1));
+        for (size_t ply = 0; ply <= undo_history.size(); ++ply)
+            accumulators[ply].computed[0] = accumulators[ply].computed[1] = false;
+    }
+
+    template<Color Us>
+    void Board::Impl::castling_rook_squares(const Square king_to, Square& rook_from, Square& rook_to) {
+        // The rook lands on the square the king crossed
+        using Side = SideTraits<Us>;
+        const bool kingside = king_to == Side::KINGSIDE_TO;
+        rook_from = kingside ? Side::KINGSIDE_ROOK : Side::QUEENSIDE_ROOK;
+        rook_to = kingside ? Side::KINGSIDE_VIA : Side::QUEENSIDE_VIA;
     }
 
     void Board::Impl::apply_move(const Move& move) {
+        const Piece piece = position.mailbox[(int)move.from()];
+        get_piece_color(piece) == Color::WHITE ? apply_move<Color::WHITE>(move, piece)
+                                               : apply_move<Color::BLACK>(move, piece);
+    }
+
+    template<Color Us>
+    void Board::Impl::apply_move(const Move& move, const Piece piece) {
+        using Side = SideTraits<Us>;
+        const Square from = move.from();
+        const Square to = move.to();
+        const Piece captured = position.mailbox[(int)to];
+        const bool pawn = get_piece_type(piece) == PieceType::PAWN;
+
         const MoveUndo undo = {
             .move = move,
-            .captured_piece = get_piece_at(move.to()),
+            .captured_piece = captured,
             .old_castle_rights = position.castle_rights,
             .old_en_passant = position.en_passant_square,
             .old_halfmove_clock = position.halfmove_clock,
             .old_hash = position.zobrist_hash,
         };
         undo_history.push_back(undo);
+        push_accumulator();
 
-        const Square from = move.from();
-        const Piece piece = get_piece_at(from);
-        Color color = get_piece_color(piece);
-        PieceType type = get_piece_type(piece);
-
+        // Derived from the pre-move board, so compute before any pieces move.
+        // A double push leaves the square it crossed open to en passant
+        const uint8_t new_castle = calculate_new_castle_rights(move);
+        const Square new_en_passant = pawn && (int)to - (int)from == 2 * Side::PUSH
+                                    ? (Square)((int)from + Side::PUSH) : Square::INVALID;
 
-        const Square to = move.to();
-        const Piece captured = get_piece_at(to);
-        if (captured != Piece::NONE) {
-            Color op_color = get_piece_color(captured);
-            PieceType op_type = get_piece_type(captured);
-            internal::toggle_bit(position.pieces[(int)op_color][(int)op_type], to);
-        }
+        if (captured != Piece::NONE)
+            remove_piece(to);
 
-        internal::toggle_bit(position.pieces[(int)color][(int)type], from);
-        internal::toggle_bit(position.pieces[(int)color][(int)type], to);
+        move_piece(from, to);
 
         if (move.flag() == MoveFlag::PROMOTION) {
-            internal::toggle_bit(position.pieces[(int)color][(int)PieceType::PAWN], to);
-            internal::toggle_bit(position.pieces[(int)color][(int)move.promotion()], to);
+            remove_piece(to);
+            put_piece(make_piece(Us, move.promotion()), to);
         }
 
         if (move.flag() == MoveFlag::CASTLING) {
-            if (to == Square::G1) {  // White kingside
-                internal::toggle_bit(position.pieces[(int)Color::WHITE][(int)PieceType::ROOK], Square::H1);
-                internal::toggle_bit(position.pieces[(int)Color::WHITE][(int)PieceType::ROOK], Square::F1);
-            } else if (to == Square::C1) {  // White queenside
-                internal::toggle_bit(position.pieces[(int)Color::WHITE][(int)PieceType::ROOK], Square::A1);
-                internal::toggle_bit(position.pieces[(int)Color::WHITE][(int)PieceType::ROOK], Square::D1);
-            } else if (to == Square::G8) {  // Black kingside
-                internal::toggle_bit(position.pieces[(int)Color::BLACK][(int)PieceType::ROOK], Square::H8);
-                internal::toggle_bit(position.pieces[(int)Color::BLACK][(int)PieceType::ROOK], Square::F8);
-            } else if (to == Square::C8) {  // Black queenside
-                internal::toggle_bit(position.pieces[(int)Color::BLACK][(int)PieceType::ROOK], Square::A8);
-                internal::toggle_bit(position.pieces[(int)Color::BLACK][(int)PieceType::ROOK], Square::D8);
-            }
+            Square rook_from, rook_to;
+            castling_rook_squares<Us>(to, rook_from, rook_to);
+            move_piece(rook_from, rook_to);
         }
 
         if (move.flag() == MoveFlag::EN_PASSANT) {
-            // Calculate pawn location (one rank back)
-            Square captured_pawn_sq = (color == Color::WHITE)
-                ? (Square)((int)to - 8)  // One rank down for black pawn
-                : (Square)((int)to + 8); // One rank up for white pawn
-
-            // Remove the captured pawn
-            Color enemy_color = (color == Color::WHITE) ? Color::BLACK : Color::WHITE;
-            internal::toggle_bit(position.pieces[(int)enemy_color][(int)PieceType::PAWN], captured_pawn_sq);
+            // The captured pawn sits one rank behind the target square
+            remove_piece((Square)((int)to - Side::PUSH));
         }
 
-        const uint8_t new_castle = calculate_new_castle_rights(move);
-        const Square new_en_passant = calculate_new_en_passant(move);
-
-        position.zobrist_hash = hasher.update(
+        position.zobrist_hash = ZobristHasher::update<Us>(
             position.zobrist_hash,
             move,
             piece,
@@ -488,82 +931,90 @@ namespace chess
 
         position.castle_rights = new_castle;
         position.en_passant_square = new_en_passant;
-        position.side_to_move = (position.side_to_move == Color::WHITE) ? Color::BLACK : Color::WHITE;
+        position.side_to_move = Side::THEM;
 
-        if (move.flag() == MoveFlag::CAPTURE || move.flag() == MoveFlag::EN_PASSANT || get_piece_type(piece) == PieceType::PAWN)
+        if (move.flag() == MoveFlag::CAPTURE || move.flag() == MoveFlag::EN_PASSANT || pawn)
             position.halfmove_clock = 0;
         else
             position.halfmove_clock++;
-        if (position.side_to_move == Color::BLACK) ++position.fullmove_number;
+        if constexpr (Us == Color::BLACK) ++position.fullmove_number;
+        dirty = nullptr;
+    }
+
+    void Board::Impl::apply_null_move() {
+        undo_history.push_back({
+            .move = Move(),
+            .captured_piece = Piece::NONE,
+            .old_castle_rights = position.castle_rights,
+            .old_en_passant = position.en_passant_square,
+            .old_halfmove_clock = position.halfmove_clock,
+            .old_hash = position.zobrist_hash,
+        });
+        push_accumulator();
+        dirty = nullptr;
 
-        update_occupancy();
+        position.zobrist_hash = ZobristHasher::update_null(position.zobrist_hash, position.en_passant_square);
+        position.en_passant_square = Square::INVALID;
+        position.side_to_move = (position.side_to_move == Color::WHITE) ? Color::BLACK : Color::WHITE;
+        position.halfmove_clock++;
+        if (position.side_to_move == Color::WHITE) ++position.fullmove_number;
     }
 
     void Board::Impl::restore_from_history() {
         const MoveUndo undo = undo_history.back();
-        const Move move = undo.move;
         undo_history.pop_back();
 
+        // === Null move: nothing moved on the board ===
+        if (undo.move == Move()) {
+            position.zobrist_hash = undo.old_hash;
+            position.en_passant_square = undo.old_en_passant;
+            position.side_to_move = (position.side_to_move == Color::WHITE) ? Color::BLACK : Color::WHITE;
+            position.halfmove_clock = undo.old_halfmove_clock;
+            if (position.side_to_move == Color::BLACK) --position.fullmove_number;
+            return;
+        }
+
+        get_piece_color(position.mailbox[(int)undo.move.to()]) == Color::WHITE ? restore_move<Color::WHITE>(undo)
+                                                                                : restore_move<Color::BLACK>(undo);
+    }
+
+    template<Color Us>
+    void Board::Impl::restore_move(const MoveUndo& undo) {
+        using Side = SideTraits<Us>;
+        const Move move = undo.move;
         const Square from = move.from();
         const Square to = move.to();
 
-        // ✓ Get piece from TO (where it currently is)
-        const Piece piece = get_piece_at(to);
-        Color color = get_piece_color(piece);
-        PieceType type = get_piece_type(piece);
-
-        // === Restore captured piece ===
-        if (undo.captured_piece != Piece::NONE) {
-            Color op_color = get_piece_color(undo.captured_piece);
-            PieceType op_type = get_piece_type(undo.captured_piece);
-            internal::toggle_bit(position.pieces[(int)op_color][(int)op_type], to);  // Put it back
+        // === Handle promotion undo ===
+        if (move.flag() == MoveFlag::PROMOTION) {
+            remove_piece(to);
+            put_piece(make_piece(Us, PieceType::PAWN), to);
         }
 
         // === Restore piece to source ===
-        internal::toggle_bit(position.pieces[(int)color][(int)type], to);    // Remove from to
-        internal::toggle_bit(position.pieces[(int)color][(int)type], from);  // Add to from
+        move_piece(to, from);
 
-        // === Restore en passant captured pawn ===
-        if (move.flag() == MoveFlag::EN_PASSANT) {
-            Square captured_pawn_sq = (color == Color::WHITE)
-                ? (Square)((int)to - 8)
-                : (Square)((int)to + 8);
-
-            Color enemy_color = (color == Color::WHITE) ? Color::BLACK : Color::WHITE;
-            internal::toggle_bit(position.pieces[(int)enemy_color][(int)PieceType::PAWN], captured_pawn_sq);
-        }
+        // === Restore captured piece ===
+        if (undo.captured_piece != Piece::NONE)
+            put_piece(undo.captured_piece, to);
 
-        // === Handle promotion undo ===
-        if (move.flag() == MoveFlag::PROMOTION) {
-            internal::toggle_bit(position.pieces[(int)color][(int)move.promotion()], from);  // Remove promoted
-            internal::toggle_bit(position.pieces[(int)color][(int)PieceType::PAWN], from);   // Add pawn back
-        }
+        // === Restore en passant captured pawn ===
+        if (move.flag() == MoveFlag::EN_PASSANT)
+            put_piece(make_piece(Side::THEM, PieceType::PAWN), (Square)((int)to - Side::PUSH));
 
         // === Handle castling undo ===
         if (move.flag() == MoveFlag::CASTLING) {
-            if (to == Square::G1) {  // White kingside
-                internal::toggle_bit(position.pieces[(int)Color::WHITE][(int)PieceType::ROOK], Square::F1);  // Remove from F1
-                internal::toggle_bit(position.pieces[(int)Color::WHITE][(int)PieceType::ROOK], Square::H1);  // Add to H1
-            } else if (to == Square::C1) {  // White queenside
-                internal::toggle_bit(position.pieces[(int)Color::WHITE][(int)PieceType::ROOK], Square::D1);
-                internal::toggle_bit(position.pieces[(int)Color::WHITE][(int)PieceType::ROOK], Square::A1);
-            } else if (to == Square::G8) {  // Black kingside
-                internal::toggle_bit(position.pieces[(int)Color::BLACK][(int)PieceType::ROOK], Square::F8);
-                internal::toggle_bit(position.pieces[(int)Color::BLACK][(int)PieceType::ROOK], Square::H8);
-            } else if (to == Square::C8) {  // Black queenside
-                internal::toggle_bit(position.pieces[(int)Color::BLACK][(int)PieceType::ROOK], Square::D8);
-                internal::toggle_bit(position.pieces[(int)Color::BLACK][(int)PieceType::ROOK], Square::A8);
-            }
+            Square rook_from, rook_to;
+            castling_rook_squares<Us>(to, rook_from, rook_to);
+            move_piece(rook_to, rook_from);
         }
 
         position.zobrist_hash = undo.old_hash;
         position.castle_rights = undo.old_castle_rights;
         position.en_passant_square = undo.old_en_passant;
-        position.side_to_move = (position.side_to_move == Color::WHITE) ? Color::BLACK : Color::WHITE;
+        position.side_to_move = Us;
         position.halfmove_clock = undo.old_halfmove_clock;
-        if (position.side_to_move == Color::WHITE) --position.fullmove_number;
-
-        update_occupancy();
+        if constexpr (Us == Color::BLACK) --position.fullmove_number;
     }
 
     Square Board::Impl::find_king(Color color) const
@@ -575,39 +1026,41 @@ namespace chess
         return (Square)internal::lsb(king_bb);
     }
 
-    void Board::Impl::update_occupancy() {
-        position.occupancy[(int)Color::WHITE] = 0;
-        position.occupancy[(int)Color::BLACK] = 0;
-        position.occupancy_all = 0;
-
-        for (int piece = 0; piece < 6; ++piece) {
-            position.occupancy[(int)Color::WHITE] |= position.pieces[(int)Color::WHITE][piece];
-            position.occupancy[(int)Color::BLACK] |= position.pieces[(int)Color::BLACK][piece];
-        }
-
-        position.occupancy_all = position.occupancy[(int)Color::WHITE] | position.occupancy[(int)Color::BLACK];
-    }
-
-    void Board::Impl::parse_board(const std::string_view& board_str, Bitboard pieces[2][6]) {
-        // Initialize all bitboards to 0
+    void Board::Impl::parse_board(const std::string_view& board_str) {
+        // Start from an empty board: bitboards, mailbox and evaluation terms
         for (int i = 0; i < 2; ++i) {
             for (int j = 0; j < 6; ++j) {
-                pieces[i][j] = 0;
+                position.pieces[i][j] = 0;
             }
+            position.occupancy[i] = 0;
+            position.material[i] = 0;
         }
+        position.occupancy_all = 0;
+        std::ranges::fill(position.mailbox, Piece::NONE);
+        position.psq_midgame = 0;
+        position.psq_endgame = 0;
+        position.phase = 0;
+        position.pawn_hash = 0;
 
-        int square = 56;  // Start at A8 (square 56, top-left)
+        // Eight ranks of eight files from A8 down; anything else would put a
+        // piece off the board, so it is rejected before touching the mailbox
+        int rank = 7, file = 0;
 
         for (const char c : board_str) {
             if (c == '/') {
-                // Move to next rank (down 2 ranks, back to a-file)
-                square -= 16;
+                // Move to next rank, back to the a-file
+                if (file != 8 || rank == 0)
+                    throw std::invalid_argument("Invalid FEN board: expected 8 ranks of 8 files");
+                --rank;
+                file = 0;
                 continue;
             }
 
-            if (std::isdigit(c)) {
+            if (c >= '1' && c <= '8') {
                 // Skip empty squares
-                square += (c - '0');
+                file += c - '0';
+                if (file > 8)
+                    throw std::invalid_argument("Invalid FEN board: rank longer than 8 files");
                 continue;
             }
 
@@ -623,25 +1076,36 @@ namespace chess
             case 'r': piece_type = PieceType::ROOK;   break;
             case 'q': piece_type = PieceType::QUEEN;  break;
             case 'k': piece_type = PieceType::KING;   break;
-            default: throw std::logic_error("Unknown piece");
+            default: throw std::invalid_argument("Invalid FEN board: unknown piece");
             }
 
-            // Set this bit in the appropriate bitboard
-            pieces[(int)color][(int)piece_type] |= (1ULL << square);
-            square++;
+            if (file == 8)
+                throw std::invalid_argument("Invalid FEN board: rank longer than 8 files");
+            put_piece(make_piece(color, piece_type), (Square)(rank * 8 + file));
+            ++file;
         }
+
+        if (rank != 0 || file != 8)
+            throw std::invalid_argument("Invalid FEN board: expected 8 ranks of 8 files");
     }
 
-    void Board::Impl::parse_fen(const std::string& fen) {
+    void Board::Impl::parse_fen(const std::string_view fen) {
         // Example: "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"
 
-        std::istringstream iss(fen);
-        std::string board_part, side_part, castle_part, ep_part, hm_part, fm_part;
-
-        iss >> board_part >> side_part >> castle_part >> ep_part >> hm_part >> fm_part;
+        // Split into fields without copying; missing ones stay empty
+        std::array<std::string_view, 6> fields;
+        size_t start = 0;
+        for (auto& field : fields) {
+            start = fen.find_first_not_of(" \t", start);
+            if (start == std::string_view::npos) break;
+            const size_t end = std::min(fen.find_first_of(" \t", start), fen.size());
+            field = fen.substr(start, end - start);
+            start = end;
+        }
+        const auto [board_part, side_part, castle_part, ep_part, hm_part, fm_part] = fields;
 
         // Parse board (process from rank 8 down to rank 1)
-        parse_board(board_part, position.pieces);
+        parse_board(board_part);
 
         // Parse side to move
         if (side_part.length() != 1)
@@ -668,14 +1132,20 @@ namespace chess
         // Parse en passant
         position.en_passant_square = string_to_square(ep_part);
 
-        // Parse halfmove/fullmove clocks
-        position.halfmove_clock = std::stoi(hm_part);
-        position.fullmove_number = std::stoi(fm_part);
+        // Parse halfmove/fullmove clocks (absent in EPD)
+        const auto parse_clock = [](const std::string_view field, const uint32_t absent) {
+            uint32_t value = absent;
+            if (field.empty()) return value;
+            const auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), value);
+            if (error != std::errc() || end != field.data() + field.size())
+                throw std::invalid_argument("Invalid move clock");
+            return value;
+        };
+        position.halfmove_clock = (uint16_t)std::min<uint32_t>(parse_clock(hm_part, 0), UINT16_MAX);
+        position.fullmove_number = parse_clock(fm_part, 1);
 
         // Compute zobrist hash
-        position.zobrist_hash = hasher.compute(position);
-
-        update_occupancy();
+        position.zobrist_hash = ZobristHasher::compute(position);
     }
 
     std::string Board::Impl::board_to_fen() const {
@@ -718,7 +1188,7 @@ namespace chess
     }
 
     void Board::Impl::reset() {
-        parse_board(DEFAULT_BOARD, position.pieces);
+        parse_board(DEFAULT_BOARD);
 
         position.side_to_move = Color::WHITE;
         position.castle_rights = 0b1111;
@@ -726,9 +1196,7 @@ namespace chess
         position.halfmove_clock = 0;
         position.fullmove_number = 1;
 
-        position.zobrist_hash = hasher.compute(position);
-
-        update_occupancy();
+        position.zobrist_hash = ZobristHasher::compute(position);
 
         undo_history.clear();
     }
@@ -767,38 +1235,26 @@ namespace chess
     }
 
     Piece Board::Impl::get_piece_at(const Square sq) const {
-        for (int color = 0; color < 2; ++color)
-            for (int piece_type = 0; piece_type < 6; ++piece_type)
-                if (internal::get_bit(position.pieces[color][piece_type], sq))
-                    return (Piece)(color * 6 + piece_type);
-        return Piece::NONE;
+        return position.mailbox[(int)sq];
     }
 
     std::vector<Square> Board::Impl::pieces_of_color(const Color color) const {
         std::vector<Square> squares;
 
-        for (int piece_type = 0; piece_type < 6; ++piece_type) {
-            Bitboard bb = position.pieces[(int)color][piece_type];
-
-            while (bb) {
-                int sq = internal::lsb(bb);
-                squares.push_back((Square)sq);
-                bb &= bb - 1;  // Pop LSB
-            }
-        }
+        for (int piece_type = 0; piece_type < 6; ++piece_type)
+            for (const Square sq : Squares(position.pieces[(int)color][piece_type]))
+                squares.push_back(sq);
 
         return squares;
     }
 
     std::vector<Square> Board::Impl::pieces_of_type(const Color color, PieceType type) const {
+        const Squares set(position.pieces[(int)color][(int)type]);
         std::vector<Square> squares;
-        Bitboard bb = position.pieces[(int)color][(int)type];
+        squares.reserve(set.size());
 
-        while (bb) {
-            int sq = internal::lsb(bb);
-            squares.push_back((Square)sq);
-            bb &= bb - 1;  // Pop LSB
-        }
+        for (const Square sq : set)
+            squares.push_back(sq);
 
         return squares;
     }
@@ -816,12 +1272,23 @@ namespace chess
     Board& Board::operator=(const Board& other)
     {
         if (this  != &other)
-            impl = std::make_unique<Impl>(*other.impl);
+            *impl = *other.impl;
         return  *this;
     }
 
-    void Board::load_fen(const std::string& fen) const {
+    Board::Board(const Position& position) : impl(std::make_unique<Impl>()) {
+        impl->position = position;
+    }
+
+    void Board::set_position(const Position& position) const {
+        impl->position = position;
+        impl->undo_history.clear();
+        impl->invalidate_accumulators();
+    }
+
+    void Board::load_fen(const std::string_view fen) const {
         impl->parse_fen(fen);
+        impl->invalidate_accumulators();
     }
 
     std::string Board::to_fen() const {
@@ -830,6 +1297,7 @@ namespace chess
 
     void Board::reset() const {
         impl->reset();
+        impl->invalidate_accumulators();
     }
 
     Piece Board::piece_at(const Square sq) const {
@@ -844,6 +1312,14 @@ namespace chess
         return impl->pieces_of_color(color);
     }
 
+    Bitboard Board::pieces(const Color color, const PieceType type) const {
+        return impl->position.pieces[(int)color][(int)type];
+    }
+
+    Bitboard Board::occupancy(const Color color) const {
+        return impl->position.occupancy[(int)color];
+    }
+
     Color Board::side_to_move() const {
         return impl->position.side_to_move;
     }
@@ -871,35 +1347,91 @@ namespace chess
     }
 
     void Board::generate_moves(MoveList& moves) const {
-        MoveList pseudo_legal;
-        impl->generate_pseudo_legal_moves(pseudo_legal);
-
-        moves.clear();
-
-        // Filter each move for legality
-        for (const auto& move : pseudo_legal)
-            if (is_legal_move(move)) moves.add(move);
+        impl->generate_legal_moves(moves, GenType::ALL);
     }
 
     void Board::generate_captures(MoveList& moves) const {
-        MoveList legal_moves;
-        generate_moves(legal_moves);
+        impl->generate_legal_moves(moves, GenType::CAPTURES);
+    }
 
-        moves.clear();
-        for (const Move& move : legal_moves)
-            if (move.is_capture()) moves.add(move);
+    void Board::generate_quiets(MoveList& moves) const {
+        impl->generate_legal_moves(moves, GenType::QUIETS);
     }
 
     bool Board::is_legal_move(const Move move) const {
-        const Color my_color = side_to_move();
-        impl->apply_move(move);
-        const bool king_safe = !impl->is_king_under_attack(my_color);
-        impl->restore_from_history();
-        return king_safe;
+        // The generators produce legal moves only, so membership is legality
+        return impl->is_generated_move(move);
+    }
+
+    Move Board::parse_san(const std::string_view text) const {
+        std::string_view san = text;
+        while (!san.empty() && std::string_view("+#!?").find(san.back()) != std::string_view::npos)
+            san.remove_suffix(1);
+
+        MoveList moves;
+        impl->generate_legal_moves(moves, GenType::ALL);
+
+        // Castling, also written with zeros
+        if (san == "O-O" || san == "0-0" || san == "O-O-O" || san == "0-0-0") {
+            const bool king_side = san.size() == 3;
+            for (const Move m : moves)
+                if (m.flag() == MoveFlag::CASTLING && (square_file(m.to()) == 6) == king_side)
+                    return m;
+            throw std::invalid_argument("Illegal move: " + std::string(text));
+        }
+
+        // [piece][from file][from rank][x]square[=promotion]
+        constexpr std::string_view PIECE_LETTERS = "PNBRQK";
+        PieceType piece = PieceType::PAWN;
+        if (!san.empty() && PIECE_LETTERS.find(san.front()) != std::string_view::npos) {
+            piece = (PieceType)PIECE_LETTERS.find(san.front());
+            san.remove_prefix(1);
+        }
+
+        PieceType promotion = PieceType::NONE;
+        if (san.size() > 2 && PIECE_LETTERS.substr(1, 4).find(san.back()) != std::string_view::npos) {
+            promotion = (PieceType)PIECE_LETTERS.find(san.back());
+            san.remove_suffix(1);
+            if (san.back() == '=') san.remove_suffix(1);
+        }
+
+        if (san.size() < 2)
+            throw std::invalid_argument("Invalid SAN move: " + std::string(text));
+        const Square to = string_to_square(san.substr(san.size() - 2));
+        san.remove_suffix(2);
+        if (!san.empty() && san.back() == 'x') san.remove_suffix(1);
+
+        int from_file = -1, from_rank = -1;
+        for (const char c : san) {
+            if (c >= 'a' && c <= 'h') from_file = c - 'a';
+            else if (c >= '1' && c <= '8') from_rank = c - '1';
+            else throw std::invalid_argument("Invalid SAN move: " + std::string(text));
+        }
+
+        Move found;
+        int matches = 0;
+        for (const Move m : moves) {
+            if (m.to() != to || get_piece_type(impl->position.mailbox[(int)m.from()]) != piece ||
+                (m.is_promotion() ? m.promotion() : PieceType::NONE) != promotion ||
+                (from_file >= 0 && square_file(m.from()) != from_file) ||
+                (from_rank >= 0 && square_rank(m.from()) != from_rank))
+                continue;
+            found = m;
+            ++matches;
+        }
+        if (matches != 1)
+            throw std::invalid_argument(std::string(matches ? "Ambiguous" : "Illegal") + " move: " + std::string(text));
+        return found;
     }
 
     void Board::make_move(const Move move) const {
-        if (!is_legal_move(move))
+        // The rest of the stack is the search's: MAX_PLY must stay free for it
+        if (impl->undo_history.size() >= MAX_GAME_PLIES)
+            throw std::length_error("Move history is full");
+
+        // apply_move trusts its move: one from an empty square or through a
+        // piece would corrupt the position, so only a generated move gets there
+        if (!impl->is_generated_move(move))
             throw std::invalid_argument("Illegal move");
         impl->apply_move(move);
     }
@@ -910,32 +1442,62 @@ namespace chess
         impl->restore_from_history();
     }
 
+    void Board::make_move_unchecked(const Move move) const {
+        impl->apply_move(move);
+    }
+
+    void Board::undo_move_unchecked() const {
+        impl->restore_from_history();
+    }
+
+    void Board::undo_move_to(const Position& snapshot) const {
+        impl->undo_history.pop_back();
+        impl->position = snapshot;
+    }
+
+    void Board::make_null_move() const {
+        impl->apply_null_move();
+    }
+
+    void Board::undo_null_move() const {
+        impl->restore_from_history();
+    }
+
     std::vector<Move> Board::move_history() const {
         return impl->get_move_history();
     }
 
     void Board::clear_history() const {
         impl->undo_history.clear();
+        impl->invalidate_accumulators();
     }
 
     bool Board::is_in_check() const {
         return impl->is_king_under_attack(side_to_move());
     }
 
-    bool Board::is_checkmate() const {
-        if (!is_in_check()) return false;
+    bool Board::has_legal_move() const {
+        return impl->has_legal_move();
+    }
 
-        MoveList moves;
-        generate_moves(moves);
-        return moves.empty();
+    bool Board::is_generated_move(const Move move) const {
+        return impl->is_generated_move(move);
     }
 
-    bool Board::is_stalemate() const {
-        if (is_in_check()) return false;
+    int Board::see(const Move move) const {
+        return impl->see(move);
+    }
 
-        MoveList moves;
-        generate_moves(moves);
-        return moves.empty();
+    bool Board::see_ge(const Move move, const int threshold) const {
+        return impl->see_ge(move, threshold);
+    }
+
+    bool Board::is_checkmate() const {
+        return is_in_check() && !has_legal_move();
+    }
+
+    bool Board::is_stalemate() const {
+        return !is_in_check() && !has_legal_move();
     }
 
     bool Board::is_50_move_draw() const {
@@ -975,6 +1537,33 @@ namespace chess
         return impl->position.zobrist_hash;
     }
 
+    uint64_t Board::pawn_hash() const {
+        return impl->position.pawn_hash;
+    }
+
+    void Board::attach_network(std::shared_ptr<const NnueNetwork> network) const {
+        impl->network = std::move(network);
+        if (impl->network)
+            impl->accumulators.reserve(MAX_GAME_PLIES + MAX_PLY + 1);
+        else
+            impl->accumulators = {};
+        impl->invalidate_accumulators();
+    }
+
+    const NnueNetwork* Board::network() const {
+        return impl->network.get();
+    }
+
+    const nnue::Accumulator& Board::accumulator() const {
+        const size_t ply = impl->undo_history.size();
+        impl->network->update(std::span(impl->accumulators.data(), ply + 1), impl->position);
+        return impl->accumulators[ply];
+    }
+
+    const Position& Board::position() const {
+        return impl->position;
+    }
+
     bool Board::is_valid_position() const {
         // TODO: Implement position validation
         return true;
@@ -0,0 +1,301 @@
+#include "chess/EnginePool.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "chess/TranspositionTable.hpp"
+
+namespace chess
+{
+    // ============================================================================
+    // Sessions
+    // ============================================================================
+
+    /// A game's share of the pool. table, lru and searching are guarded by the pool's mutex
+    struct EngineSession::State {
+        std::shared_ptr<EnginePool::Impl> pool;
+        std::shared_ptr<TranspositionTable> table;
+        std::list<State*>::iterator lru;    // Its place among the sessions holding a table
+        int searching = 0;                  // Its searches running now; a busy table is never reclaimed
+
+        explicit State(std::shared_ptr<EnginePool::Impl> pool) : pool(std::move(pool)) {}
+        ~State();
+    };
+
+    // ============================================================================
+    // EnginePool::Impl
+    // ============================================================================
+
+    class EnginePool::Impl {
+    public:
+        using SearchLimit = std::variant<Depth, std::chrono::milliseconds, TimeControl>;
+
+        struct Job {
+            std::shared_ptr<EngineSession::State> session;
+            Board board;
+            SearchLimit limit;
+            std::stop_source stop;
+            std::promise<SearchResult> promise;
+        };
+
+        EnginePoolConfig config;
+        size_t table_limit;
+
+        // Guards everything below and every session's table state
+        mutable std::mutex mutex;
+        std::condition_variable work_cv;
+        std::deque<Job> queue;
+        std::vector<std::stop_source> running;      // Each thread's current search, to cancel at shutdown
+        std::vector<std::shared_ptr<TranspositionTable>> free_tables;
+        std::list<EngineSession::State*> lru;       // Sessions holding a table, most recently searched first
+        size_t allocated = 0;
+        uint64_t reclaimed = 0;
+        bool shutting_down = false;
+
+        std::vector<std::unique_ptr<Engine>> engines;
+        std::vector<std::thread> threads;
+
+        explicit Impl(const EnginePoolConfig& cfg);
+
+        PendingSearch submit(const std::shared_ptr<EngineSession::State>& session, const Board& board,
+                             const SearchLimit& limit);
+        void start(const std::shared_ptr<Impl>& self);
+        void shutdown();
+
+        void new_game(EngineSession::State& session);
+        void release(EngineSession::State& session);
+
+    private:
+        void work(size_t id);
+        std::shared_ptr<TranspositionTable> check_out(EngineSession::State& session);
+        void check_in(EngineSession::State& session, size_t id);
+    };
+
+    EnginePool::Impl::Impl(const EnginePoolConfig& cfg) : config(cfg) {
+        if (config.threads <= 0)
+            config.threads = (int)std::max(1u, std::thread::hardware_concurrency());
+        if (config.session_tt_mb < 1)
+            throw std::invalid_argument("EnginePool session table size must be at least 1 MB");
+
+        table_limit = config.memory_mb / (size_t)config.session_tt_mb;
+        if (table_limit < (size_t)config.threads)
+            throw std::invalid_argument("EnginePool memory budget must hold a session table for every thread");
+
+        // Tables come from the sessions; an engine gets one per search
+        for (int id = 0; id < config.threads; ++id) {
+            engines.push_back(std::make_unique<Engine>(config.search, nullptr));
+            if (config.network) engines.back()->set_network(config.network);
+        }
+        running.resize(engines.size(), std::stop_source(std::nostopstate));
+    }
+
+    void EnginePool::Impl::start(const std::shared_ptr<Impl>& self) {
+        // The threads only run while the pool object exists, which holds `self`
+        for (size_t id = 0; id < engines.size(); ++id)
+            threads.emplace_back([impl = self.get(), id] { impl->work(id); });
+    }
+
+    PendingSearch EnginePool::Impl::submit(const std::shared_ptr<EngineSession::State>& session, const Board& board,
+                                           const SearchLimit& limit) {
+        Job job { session, board, limit, {}, {} };
+        PendingSearch pending { job.promise.get_future(), job.stop };
+        {
+            std::lock_guard lock(mutex);
+            if (shutting_down)
+                throw std::logic_error("EnginePool has shut down");
+            queue.push_back(std::move(job));
+        }
+        work_cv.notify_one();
+        return pending;
+    }
+
+    void EnginePool::Impl::work(const size_t id) {
+        const Engine& engine = *engines[id];
+
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock lock(mutex);
+                work_cv.wait(lock, [this] { return shutting_down || !queue.empty(); });
+                if (queue.empty()) return;  // Shutting down, and every queued search is answered
+
+                job = std::move(queue.front());
+                queue.pop_front();
+                running[id] = job.stop;
+            }
+
+            std::optional<SearchResult> result;
+            std::exception_ptr error;
+            try {
+                engine.set_table(check_out(*job.session));
+                SearchConfig search = config.search;
+                search.stop_token = job.stop.get_token();
+                engine.set_config(search);
+
+                result = std::visit([&](const auto& limit) {
+                    return engine.find_best_move(job.board, limit);
+                }, job.limit);
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            // The session is done with its table before its future is ready
+            engine.set_table(nullptr);
+            check_in(*job.session, id);
+            if (result) job.promise.set_value(std::move(*result));
+            else job.promise.set_exception(error);
+        }
+    }
+
+    std::shared_ptr<TranspositionTable> EnginePool::Impl::check_out(EngineSession::State& session) {
+        std::lock_guard lock(mutex);
+        ++session.searching;
+
+        if (session.table) {
+            lru.splice(lru.begin(), lru, session.lru);
+            return session.table;
+        }
+
+        // A spare table, a new one while the budget allows, or the least recently
+        // used idle session's. Each search holds one table, and there is one table
+        // per thread at least, so with every table taken some holder is idle.
+        // Tables are small, so clearing under the lock costs less than a search ply
+        std::shared_ptr<TranspositionTable> table;
+        if (!free_tables.empty()) {
+            table = std::move(free_tables.back());
+            free_tables.pop_back();
+            table->clear();
+        } else if (allocated < table_limit) {
+            table = std::make_shared<TranspositionTable>((size_t)config.session_tt_mb);
+            ++allocated;
+        } else {
+            auto victim = std::find_if(lru.rbegin(), lru.rend(),
+                                       [](const EngineSession::State* s) { return s->searching == 0; });
+            table = std::move((*victim)->table);
+            lru.erase(std::next(victim).base());
+            ++reclaimed;
+            table->clear();
+        }
+
+        session.table = table;
+        lru.push_front(&session);
+        session.lru = lru.begin();
+        return table;
+    }
+
+    void EnginePool::Impl::check_in(EngineSession::State& session, const size_t id) {
+        std::lock_guard lock(mutex);
+        --session.searching;
+        running[id] = std::stop_source(std::nostopstate);
+    }
+
+    void EnginePool::Impl::new_game(EngineSession::State& session) {
+        std::lock_guard lock(mutex);
+        if (session.searching > 0)
+            throw std::logic_error("Session is searching");
+        if (!session.table) return;
+
+        free_tables.push_back(std::move(session.table));
+        lru.erase(session.lru);
+    }
+
+    void EnginePool::Impl::release(EngineSession::State& session) {
+        // Queued and running searches hold the session, so none is left here
+        std::lock_guard lock(mutex);
+        if (!session.table) return;
+
+        free_tables.push_back(std::move(session.table));
+        lru.erase(session.lru);
+    }
+
+    void EnginePool::Impl::shutdown() {
+        {
+            std::lock_guard lock(mutex);
+            shutting_down = true;
+            for (Job& job : queue)
+                job.stop.request_stop();
+            for (std::stop_source& stop : running)
+                stop.request_stop();
+        }
+        work_cv.notify_all();
+
+        for (auto& thread : threads)
+            thread.join();
+        threads.clear();
+    }
+
+    EngineSession::State::~State() {
+        pool->release(*this);
+    }
+
+    // ============================================================================
+    // EngineSession
+    // ============================================================================
+
+    EngineSession::EngineSession(std::shared_ptr<State> state) : state(std::move(state)) {}
+
+    PendingSearch EngineSession::find_best_move(const Board& board, const Depth max_depth) const {
+        return state->pool->submit(state, board, max_depth);
+    }
+
+    PendingSearch EngineSession::find_best_move(const Board& board, const std::chrono::milliseconds time_limit) const {
+        return state->pool->submit(state, board, time_limit);
+    }
+
+    PendingSearch EngineSession::find_best_move(const Board& board, const TimeControl& time_control) const {
+        return state->pool->submit(state, board, time_control);
+    }
+
+    void EngineSession::new_game() const {
+        state->pool->new_game(*state);
+    }
+
+    bool EngineSession::resident() const {
+        std::lock_guard lock(state->pool->mutex);
+        return state->table != nullptr;
+    }
+
+    // ============================================================================
+    // EnginePool
+    // ============================================================================
+
+    EnginePool::EnginePool(const EnginePoolConfig& config) : impl(std::make_shared<Impl>(config)) {
+        impl->start(impl);
+    }
+
+    EnginePool::~EnginePool() {
+        impl->shutdown();
+    }
+
+    EngineSession EnginePool::open_session() const {
+        return EngineSession(std::make_shared<EngineSession::State>(impl));
+    }
+
+    int EnginePool::thread_count() const {
+        return (int)impl->engines.size();
+    }
+
+    size_t EnginePool::table_limit() const {
+        return impl->table_limit;
+    }
+
+    size_t EnginePool::resident_tables() const {
+        std::lock_guard lock(impl->mutex);
+        return impl->allocated;
+    }
+
+    uint64_t EnginePool::reclaimed_tables() const {
+        std::lock_guard lock(impl->mutex);
+        return impl->reclaimed;
+    }
+
+}  // namespace chess
@@ -0,0 +1,109 @@
+#include "chess/EpdReader.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace chess
+{
+    namespace
+    {
+        constexpr std::string_view WHITESPACE = " \t\r\n";
+
+        std::string_view trim(std::string_view s) {
+            const size_t first = s.find_first_not_of(WHITESPACE);
+            if (first == std::string_view::npos) return {};
+            return s.substr(first, s.find_last_not_of(WHITESPACE) - first + 1);
+        }
+
+        /// The field starting at or after `pos`, which is moved past it; empty at the end
+        std::string_view next_field(const std::string_view s, size_t& pos) {
+            const size_t start = s.find_first_not_of(WHITESPACE, pos);
+            if (start == std::string_view::npos) {
+                pos = s.size();
+                return {};
+            }
+            pos = std::min(s.find_first_of(WHITESPACE, start), s.size());
+            return s.substr(start, pos - start);
+        }
+
+        bool is_number(const std::string_view s) {
+            return !s.empty() && std::ranges::all_of(s, [](const char c) { return c >= '0' && c <= '9'; });
+        }
+    }
+
+    std::optional<std::string_view> EpdRecord::operation(const std::string_view opcode) const
+    {
+        // Operations end in ';', which may also appear inside a quoted operand
+        size_t start = 0;
+        bool quoted = false;
+        for (size_t i = 0; i <= operations.size(); ++i) {
+            if (i < operations.size()) {
+                if (operations[i] == '"') quoted = !quoted;
+                if (operations[i] != ';' || quoted) continue;
+            }
+
+            const std::string_view op = trim(operations.substr(start, i - start));
+            start = i + 1;
+
+            const size_t space = std::min(op.find_first_of(WHITESPACE), op.size());
+            if (op.empty() || op.substr(0, space) != opcode) continue;
+
+            std::string_view operand = trim(op.substr(space));
+            if (operand.size() >= 2 && operand.front() == '"' && operand.back() == '"')
+                operand = operand.substr(1, operand.size() - 2);
+            return operand;
+        }
+        return std::nullopt;
+    }
+
+    EpdReader::EpdReader(const std::string_view text) : text(text) {}
+
+    EpdReader EpdReader::open(const std::string& path)
+    {
+        internal::MappedFile mapped(path);
+        EpdReader reader({ reinterpret_cast<const char*>(mapped.data()), mapped.size() });
+        reader.file = std::move(mapped);
+        return reader;
+    }
+
+    bool EpdReader::next(EpdRecord& record)
+    {
+        while (pos < text.size()) {
+            const size_t end = std::min(text.find('\n', pos), text.size());
+            const std::string_view line = text.substr(pos, end - pos);
+            pos = std::min(end + 1, text.size());
+            if (parse(line, record))
+                return true;
+        }
+        return false;
+    }
+
+    bool EpdReader::parse(const std::string_view raw, EpdRecord& record)
+    {
+        const std::string_view line = trim(raw);
+        if (line.empty() || line.front() == '#')
+            return false;
+
+        size_t pos = 0;
+        for (int i = 0; i < 4; ++i) {
+            if (next_field(line, pos).empty())
+                throw std::invalid_argument("Expected four FEN fields: " + std::string(line));
+        }
+        size_t fen_end = pos;
+
+        // A full FEN goes on with its two clocks, an EPD line with operations
+        record.clocks = {};
+        size_t after_clocks = pos;
+        const std::string_view halfmove = next_field(line, after_clocks);
+        const std::string_view fullmove = next_field(line, after_clocks);
+        if (is_number(halfmove) && is_number(fullmove)) {
+            record.clocks = trim(line.substr(pos, after_clocks - pos));
+            fen_end = after_clocks;
+        }
+
+        record.fen = line.substr(0, fen_end);
+        record.operations = trim(line.substr(fen_end));
+        return true;
+    }
+
+}  // namespace chess
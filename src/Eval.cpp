@@ -1,94 +1,73 @@
 #include "chess/Eval.hpp"
 
+#include <algorithm>
+
+#include "chess/Nnue.hpp"
+#include "chess/PawnStructure.hpp"
 #include "chess/PieceSquareTables.hpp"
 
 namespace chess
 {
-    PieceType get_piece_type(const Piece p)
-    {
-        return (PieceType)((int)p % 6);
-    }
-
-    Color get_piece_color(const Piece p)
-    {
-        return (Color)((int)p / 6);
-    }
-
     class Evaluator::Impl
     {
         private:
-            const PieceSquareTables& pst;
+            PawnHashTable pawn_table;   // Shared by every search thread using this evaluator
 
         public:
-            explicit Impl(const PieceSquareTables& pst) : pst(pst) {}
+            std::shared_ptr<const NnueNetwork> network;
 
             Score evaluate(const Board& board);
+            Score evaluate_nnue(const Board& board) const;
             Score get_material(const Board& board, Color color);
-            double get_game_phase(const Board& board);
+            int get_game_phase(const Board& board);
 
     };
 
     Score Evaluator::Impl::evaluate(const Board& board) {
-        Score score = 0;
-        const double phase = get_game_phase(board);
-
-        // Evaluate material and position
-        for (const Color color : {Color::WHITE, Color::BLACK}) {
-            const int sign = (color == Color::WHITE) ? 1 : -1;
-
-            for (int pt_idx = 0; pt_idx < 6; ++pt_idx) {
-                const auto pt = static_cast<PieceType>(pt_idx);
-                auto pieces = board.pieces_of_type(color, pt);
-                for (const Square sq : pieces) {
-                    // Material value
-                    const Score material = PIECE_VALUES[(int)pt];
-
-                    // PST value (phase-interpolated)
-                    const int value = pst.get_value(pt, sq, color, phase);
-
-                    score += (sign * (material + value));
-                }
-            }
-        }
+        if (network)
+            return evaluate_nnue(board);
+
+        // Material and piece-square sums are maintained by make/unmake and pawn
+        // structure comes from the pawn hash, so the static eval is mostly a
+        // tapered blend of a few integers
+        const Position& pos = board.position();
+        const int phase = get_game_phase(board);
+        const PawnScore pawns = pawn_table.probe(pos);
+        const Score midgame = pos.psq_midgame + pawns.midgame + king_pawn_shields(pos);
+        const Score endgame = pos.psq_endgame + pawns.endgame;
+        const Score score = (midgame * phase + endgame * (256 - phase)) / 256;
+
+        return pos.side_to_move == Color::WHITE ? score : -score;
+    }
 
-        return score;
+    Score Evaluator::Impl::evaluate_nnue(const Board& board) const
+    {
+        // Boards carrying accumulators for this network update incrementally;
+        // any other board pays for a full refresh
+        if (board.network() == network.get())
+            return network->evaluate(board.accumulator(), board.side_to_move());
+
+        nnue::Accumulator acc;
+        network->refresh(acc, board.position(), Color::WHITE);
+        network->refresh(acc, board.position(), Color::BLACK);
+        return network->evaluate(acc, board.side_to_move());
     }
 
     Score Evaluator::Impl::get_material(const Board& board, const Color color)
     {
-        Score material = 0;
-        const double phase = get_game_phase(board);
-        for (const auto sq : board.pieces_of_color(color)) {
-            const Piece p = board.piece_at(sq);
-            const PieceType pt = get_piece_type(p);
-
-            material += pst.get_value(pt, sq, color, phase);
-        }
-        return material;
+        const Position& pos = board.position();
+        return pos.material[(int)color] - pos.material[(int)color ^ 1];
     }
 
-    double Evaluator::Impl::get_game_phase(const Board& board)
+    int Evaluator::Impl::get_game_phase(const Board& board)
     {
-        int pieces = 0;
-
-        for (const Color color : {Color::WHITE, Color::BLACK}) {
-            pieces += board.pieces_of_type(color, PieceType::KNIGHT).size();
-            pieces += board.pieces_of_type(color, PieceType::BISHOP).size();
-            pieces += board.pieces_of_type(color, PieceType::ROOK).size() * 2;
-            pieces += board.pieces_of_type(color, PieceType::QUEEN).size() * 4;
-        }
-
-        pieces = std::min(pieces, 24);
-        return static_cast<double>(pieces * 256) / 24.0;
+        // 256 = opening (all non-pawn material), 0 = bare kings and pawns
+        const int pieces = std::min<int>(board.position().phase, MAX_PHASE);
+        return pieces * 256 / MAX_PHASE;
     }
 
 
-    Evaluator::Evaluator() {
-        PieceSquareTables pst;
-        impl = std::make_unique<Impl>(pst);
-    }
-
-    Evaluator::Evaluator(const PieceSquareTables& pst): impl(std::make_unique<Impl>(pst)) {}
+    Evaluator::Evaluator() : impl(std::make_unique<Impl>()) {}
 
     Evaluator::~Evaluator() = default;
 
@@ -100,7 +79,7 @@ namespace chess
     Score Evaluator::evaluate_white(const Board& board) const
     {
         Score eval = impl->evaluate(board);
-        if (board.side_to_move() == Color::WHITE)
+        if (board.side_to_move() == Color::BLACK)
             eval = -eval;
         return eval;
     }
@@ -115,6 +94,16 @@ namespace chess
         return impl->get_game_phase(board);
     }
 
+    void Evaluator::set_network(std::shared_ptr<const NnueNetwork> network)
+    {
+        impl->network = std::move(network);
+    }
+
+    const std::shared_ptr<const NnueNetwork>& Evaluator::network() const
+    {
+        return impl->network;
+    }
+
 }
 
 
@@ -0,0 +1,186 @@
+#include "chess/Nnue.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+#include "chess/ZobristHasher.hpp"
+#include "chess/internal/Bitboard.hpp"
+#include "chess/internal/Simd.hpp"
+
+namespace chess
+{
+    using namespace nnue;
+
+    static_assert(HIDDEN % internal::SIMD_WIDTH == 0);
+
+    namespace
+    {
+        struct Header {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t king_buckets;
+            uint32_t hidden;
+        };
+
+        Square king_square(const Position& pos, const Color color) {
+            return (Square)internal::lsb(pos.pieces[(int)color][(int)PieceType::KING]);
+        }
+
+        /// A king move of `perspective`'s side into another bucket changes every
+        /// one of that side's features
+        bool needs_refresh(const DirtyPieces& dirty, const Color perspective) {
+            const Piece king = make_piece(perspective, PieceType::KING);
+            for (int i = 0; i < dirty.count; ++i) {
+                const DirtyPiece& d = dirty.pieces[i];
+                if (d.piece == king && d.from != Square::INVALID && d.to != Square::INVALID &&
+                    NnueNetwork::king_bucket(perspective, d.from) != NnueNetwork::king_bucket(perspective, d.to))
+                    return true;
+            }
+            return false;
+        }
+    }
+
+    // ============================================================================
+    // Loading
+    // ============================================================================
+
+    NnueNetwork::NnueNetwork(internal::MappedFile mapped) : file(std::move(mapped))
+    {
+        const std::byte* data = file.data() + HEADER_BYTES;
+        feature_weights = reinterpret_cast<const int16_t*>(data);
+        feature_biases = feature_weights + (size_t)INPUTS * HIDDEN;
+        output_weights = feature_biases + HIDDEN;
+        std::memcpy(&output_bias, output_weights + 2 * HIDDEN, sizeof(output_bias));
+    }
+
+    std::shared_ptr<const NnueNetwork> NnueNetwork::load(const std::string& path)
+    {
+        if constexpr (std::endian::native != std::endian::little)
+            throw std::runtime_error("NNUE files are little-endian; this platform is not supported");
+
+        internal::MappedFile mapped(path);
+        if (mapped.size() != FILE_BYTES)
+            throw std::runtime_error("Not an NNUE network of this architecture (wrong size): " + path);
+
+        Header header {};
+        std::memcpy(&header, mapped.data(), sizeof(header));
+        if (header.magic != MAGIC || header.version != VERSION ||
+            header.king_buckets != KING_BUCKETS || header.hidden != HIDDEN)
+            throw std::runtime_error("Not an NNUE network of this architecture (bad header): " + path);
+
+        return std::shared_ptr<const NnueNetwork>(new NnueNetwork(std::move(mapped)));
+    }
+
+    // ============================================================================
+    // Features
+    // ============================================================================
+
+    int NnueNetwork::king_bucket(const Color perspective, const Square king)
+    {
+        // Queen side / king side, home ranks / advanced
+        const int relative = (int)king ^ (perspective == Color::WHITE ? 0 : 56);
+        return (relative / 8 >= 2 ? 2 : 0) + (relative % 8 >= 4 ? 1 : 0);
+    }
+
+    int NnueNetwork::feature_index(const Color perspective, const Square king, const Piece piece, const Square sq)
+    {
+        const int flip = perspective == Color::WHITE ? 0 : 56;
+        const int side = get_piece_color(piece) == perspective ? 0 : 6;
+        return king_bucket(perspective, king) * 768 +
+               (side + (int)get_piece_type(piece)) * 64 + ((int)sq ^ flip);
+    }
+
+    // ============================================================================
+    // Accumulators
+    // ============================================================================
+
+    void NnueNetwork::refresh(Accumulator& acc, const Position& pos, const Color perspective) const
+    {
+        const int p = (int)perspective;
+        const Square king = king_square(pos, perspective);
+        std::memcpy(acc.values[p], feature_biases, sizeof(acc.values[p]));
+
+        // Add feature rows in batches so each lane is loaded and stored once per batch
+        constexpr int BATCH = 8;
+        const int16_t* rows[BATCH];
+        int count = 0;
+        for (int sq = 0; sq < 64; ++sq) {
+            const Piece piece = pos.mailbox[sq];
+            if (piece == Piece::NONE)
+                continue;
+            rows[count++] = row(feature_index(perspective, king, piece, (Square)sq));
+            if (count == BATCH) {
+                internal::add_sub_rows(acc.values[p], acc.values[p], HIDDEN, rows, count, nullptr, 0);
+                count = 0;
+            }
+        }
+        if (count > 0)
+            internal::add_sub_rows(acc.values[p], acc.values[p], HIDDEN, rows, count, nullptr, 0);
+
+        acc.computed[p] = true;
+    }
+
+    void NnueNetwork::update(const std::span<Accumulator> stack, const Position& pos) const
+    {
+        const size_t top = stack.size() - 1;
+
+        for (const Color perspective : { Color::WHITE, Color::BLACK }) {
+            const int p = (int)perspective;
+            if (stack[top].computed[p])
+                continue;
+
+            // Nearest computed ancestor, unless a bucket change lies in between
+            size_t base = top;
+            bool refresh_needed = false;
+            while (!stack[base].computed[p]) {
+                if (base == 0 || needs_refresh(stack[base].dirty, perspective)) {
+                    refresh_needed = true;
+                    break;
+                }
+                --base;
+            }
+            if (refresh_needed) {
+                refresh(stack[top], pos, perspective);
+                continue;
+            }
+
+            // No bucket change since `base`, so today's king square gives every
+            // intermediate position's bucket too
+            const Square king = king_square(pos, perspective);
+            for (size_t i = base + 1; i <= top; ++i) {
+                const DirtyPieces& dirty = stack[i].dirty;
+                const int16_t* added[4];
+                const int16_t* removed[4];
+                int add_count = 0, remove_count = 0;
+                for (int k = 0; k < dirty.count; ++k) {
+                    const DirtyPiece& d = dirty.pieces[k];
+                    if (d.from != Square::INVALID)
+                        removed[remove_count++] = row(feature_index(perspective, king, d.piece, d.from));
+                    if (d.to != Square::INVALID)
+                        added[add_count++] = row(feature_index(perspective, king, d.piece, d.to));
+                }
+                internal::add_sub_rows(stack[i].values[p], stack[i - 1].values[p], HIDDEN,
+                                       added, add_count, removed, remove_count);
+                stack[i].computed[p] = true;
+            }
+        }
+    }
+
+    // ============================================================================
+    // Output
+    // ============================================================================
+
+    Score NnueNetwork::evaluate(const Accumulator& acc, const Color side_to_move) const
+    {
+        const int us = (int)side_to_move;
+        const int64_t output = (int64_t)output_bias +
+            internal::crelu_dot(acc.values[us], output_weights, HIDDEN, QA) +
+            internal::crelu_dot(acc.values[us ^ 1], output_weights + HIDDEN, HIDDEN, QA);
+        // Kept well clear of the mate band whatever the weights
+        constexpr int64_t MAX_EVAL = CHECKMATE / 2;
+        return (Score)std::clamp<int64_t>(output * EVAL_SCALE / (QA * QB), -MAX_EVAL, MAX_EVAL);
+    }
+
+}  // namespace chess
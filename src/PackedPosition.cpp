@@ -0,0 +1,105 @@
+#include "chess/PackedPosition.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+#include "chess/PieceSquareTables.hpp"
+#include "chess/ZobristHasher.hpp"
+#include "chess/internal/Bitboard.hpp"
+
+namespace chess
+{
+    namespace
+    {
+        constexpr uint8_t NO_EN_PASSANT = 64;
+
+        template<typename T>
+        constexpr T little_endian(const T v) {
+            if constexpr (std::endian::native == std::endian::big) return std::byteswap(v);
+            else return v;
+        }
+    }
+
+    PackedPosition PackedPosition::pack(const Position& pos)
+    {
+        PackedPosition packed {};
+        packed.occupancy = little_endian(pos.occupancy_all);
+
+        int nibble = 0;
+        for (const Square sq : Squares(pos.occupancy_all)) {
+            packed.pieces[nibble / 2] |= (uint8_t)((int)pos.mailbox[(int)sq] << (nibble % 2 * 4));
+            ++nibble;
+        }
+
+        packed.fullmove_number = little_endian((uint16_t)std::min<uint32_t>(pos.fullmove_number, UINT16_MAX));
+        packed.state = (uint8_t)((int)pos.side_to_move | pos.castle_rights << 1);
+        packed.en_passant = pos.en_passant_square == Square::INVALID ? NO_EN_PASSANT : (uint8_t)pos.en_passant_square;
+        packed.halfmove_clock = (uint8_t)std::min<int>(pos.halfmove_clock, UINT8_MAX);
+        return packed;
+    }
+
+    Position PackedPosition::unpack() const
+    {
+        const Bitboard occupied = little_endian(occupancy);
+        if (std::popcount(occupied) > 32 || en_passant > NO_EN_PASSANT || (state >> 5) != 0)
+            throw std::invalid_argument("Corrupt packed position");
+
+        Position pos {};
+        std::ranges::fill(pos.mailbox, Piece::NONE);
+
+        int nibble = 0;
+        for (const Square sq : Squares(occupied)) {
+            const int value = pieces[nibble / 2] >> (nibble % 2 * 4) & 0xF;
+            ++nibble;
+            if (value >= 12)
+                throw std::invalid_argument("Corrupt packed position");
+
+            const Piece piece = (Piece)value;
+            const int color = (int)get_piece_color(piece);
+            const int type = (int)get_piece_type(piece);
+            const Bitboard bb = 1ULL << (int)sq;
+            pos.pieces[color][type] |= bb;
+            pos.occupancy[color] |= bb;
+            pos.mailbox[(int)sq] = piece;
+            pos.psq_midgame += psq_midgame(piece, sq);
+            pos.psq_endgame += psq_endgame(piece, sq);
+            pos.material[color] += (Score)PIECE_VALUES[type];
+            pos.phase += PHASE_WEIGHTS[type];
+        }
+        pos.occupancy_all = occupied;
+
+        if (std::popcount(pos.pieces[0][(int)PieceType::KING]) != 1 || std::popcount(pos.pieces[1][(int)PieceType::KING]) != 1)
+            throw std::invalid_argument("Corrupt packed position: each side needs one king");
+
+        pos.side_to_move = (Color)(state & 1);
+        pos.castle_rights = (uint8_t)(state >> 1);
+        pos.en_passant_square = en_passant == NO_EN_PASSANT ? Square::INVALID : (Square)en_passant;
+        pos.halfmove_clock = halfmove_clock;
+        pos.fullmove_number = little_endian(fullmove_number);
+        pos.zobrist_hash = ZobristHasher::compute(pos);
+        pos.pawn_hash = ZobristHasher::compute_pawns(pos);
+        return pos;
+    }
+
+    void PackedPosition::write(std::ostream& out, const std::span<const PackedPosition> positions)
+    {
+        out.write(reinterpret_cast<const char*>(positions.data()), (std::streamsize)positions.size_bytes());
+        if (!out)
+            throw std::runtime_error("Cannot write packed positions");
+    }
+
+    size_t PackedPosition::read(std::istream& in, const std::span<PackedPosition> buffer)
+    {
+        in.read(reinterpret_cast<char*>(buffer.data()), (std::streamsize)buffer.size_bytes());
+        return (size_t)in.gcount() / sizeof(PackedPosition);
+    }
+
+    std::span<const PackedPosition> PackedPosition::view(const internal::MappedFile& file)
+    {
+        if (file.size() % sizeof(PackedPosition) != 0)
+            throw std::invalid_argument("Not a packed position file (size is not a multiple of 32)");
+        return { reinterpret_cast<const PackedPosition*>(file.data()), file.size() / sizeof(PackedPosition) };
+    }
+
+}  // namespace chess
@@ -0,0 +1,173 @@
+#include "chess/PawnStructure.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#include "chess/internal/Bitboard.hpp"
+
+namespace chess
+{
+    using namespace internal;
+
+    // ============================================================================
+    // Masks and weights
+    // ============================================================================
+
+    namespace
+    {
+        constexpr Bitboard FILE_A = 0x0101010101010101ULL;
+        constexpr Bitboard RANK_1 = 0xFFULL;
+
+        constexpr Score DOUBLED_MG = -10, DOUBLED_EG = -20;
+        constexpr Score ISOLATED_MG = -12, ISOLATED_EG = -16;
+        constexpr Score BACKWARD_MG = -8, BACKWARD_EG = -10;
+
+        // Indexed by rank from the pawn's own side (1 = its second rank)
+        constexpr Score PASSED_MG[8] = { 0, 5, 10, 15, 25, 40, 60, 0 };
+        constexpr Score PASSED_EG[8] = { 0, 10, 20, 35, 60, 100, 150, 0 };
+
+        // Per shield pawn one and two ranks in front of the king
+        constexpr Score SHIELD_NEAR = 12;
+        constexpr Score SHIELD_FAR = 6;
+
+        constexpr Bitboard file_mask(const int file) {
+            return FILE_A << file;
+        }
+
+        constexpr Bitboard rank_mask(const int rank) {
+            return RANK_1 << (8 * rank);
+        }
+
+        constexpr Bitboard adjacent_files(const int file) {
+            return (file > 0 ? file_mask(file - 1) : 0) | (file < 7 ? file_mask(file + 1) : 0);
+        }
+
+        /// All ranks strictly ahead of `rank` from `Us`'s point of view
+        template<Color Us>
+        constexpr Bitboard ranks_ahead(const int rank) {
+            if constexpr (Us == Color::WHITE) return rank < 7 ? ~0ULL << (8 * (rank + 1)) : 0;
+            else return rank > 0 ? ~0ULL >> (8 * (8 - rank)) : 0;
+        }
+
+        /// Rank counted from `Us`'s side of the board
+        template<Color Us>
+        constexpr int relative_rank(const int rank) {
+            return Us == Color::WHITE ? rank : 7 - rank;
+        }
+
+        template<Color Us>
+        PawnScore evaluate_side(const Position& pos) {
+            constexpr Color them = Us == Color::WHITE ? Color::BLACK : Color::WHITE;
+            constexpr int push = Us == Color::WHITE ? 8 : -8;
+            const Bitboard ours = pos.pieces[(int)Us][(int)PieceType::PAWN];
+            const Bitboard theirs = pos.pieces[(int)them][(int)PieceType::PAWN];
+
+            PawnScore score;
+            for (const Square sq : Squares(ours)) {
+                const int file = square_file(sq);
+                const int rank = square_rank(sq);
+                const Bitboard ahead = ranks_ahead<Us>(rank);
+                const Bitboard neighbours = ours & adjacent_files(file);
+
+                // Only the rear pawn of a doubled pair is penalised, and only the
+                // front one can be passed
+                const bool doubled = (ours & file_mask(file) & ahead) != 0;
+                const bool isolated = neighbours == 0;
+                const bool passed = !doubled &&
+                    (theirs & (file_mask(file) | adjacent_files(file)) & ahead) == 0;
+
+                // No neighbour level with or behind it to support an advance, and
+                // the stop square is covered by an enemy pawn
+                const Square stop = (Square)((int)sq + push);
+                const bool backward = !isolated && !passed &&
+                    (neighbours & ~ahead) == 0 &&
+                    (PAWN_ATTACKS[(int)Us][(int)stop] & theirs) != 0;
+
+                if (doubled) { score.midgame += DOUBLED_MG; score.endgame += DOUBLED_EG; }
+                if (isolated) { score.midgame += ISOLATED_MG; score.endgame += ISOLATED_EG; }
+                if (backward) { score.midgame += BACKWARD_MG; score.endgame += BACKWARD_EG; }
+                if (passed) {
+                    score.midgame += PASSED_MG[relative_rank<Us>(rank)];
+                    score.endgame += PASSED_EG[relative_rank<Us>(rank)];
+                }
+            }
+            return score;
+        }
+
+        template<Color Us>
+        Score king_pawn_shield(const Position& pos) {
+            const Bitboard king = pos.pieces[(int)Us][(int)PieceType::KING];
+            if (king == 0)
+                return 0;
+
+            const auto sq = (Square)lsb(king);
+            const int rank = square_rank(sq);
+            if (relative_rank<Us>(rank) > 1)
+                return 0;
+
+            constexpr int step = Us == Color::WHITE ? 1 : -1;
+            const int file = square_file(sq);
+            const Bitboard zone = file_mask(file) | adjacent_files(file);
+            const Bitboard pawns = pos.pieces[(int)Us][(int)PieceType::PAWN] & zone;
+
+            return SHIELD_NEAR * popcount(pawns & rank_mask(rank + step)) +
+                   SHIELD_FAR * popcount(pawns & rank_mask(rank + 2 * step));
+        }
+    }
+
+    // ============================================================================
+    // Evaluation terms
+    // ============================================================================
+
+    PawnScore evaluate_pawn_structure(const Position& pos)
+    {
+        const PawnScore white = evaluate_side<Color::WHITE>(pos);
+        const PawnScore black = evaluate_side<Color::BLACK>(pos);
+        return { white.midgame - black.midgame, white.endgame - black.endgame };
+    }
+
+    Score king_pawn_shield(const Position& pos, const Color color)
+    {
+        return color == Color::WHITE ? king_pawn_shield<Color::WHITE>(pos) : king_pawn_shield<Color::BLACK>(pos);
+    }
+
+    Score king_pawn_shields(const Position& pos)
+    {
+        return king_pawn_shield<Color::WHITE>(pos) - king_pawn_shield<Color::BLACK>(pos);
+    }
+
+    // ============================================================================
+    // Pawn hash table
+    // ============================================================================
+
+    PawnHashTable::PawnHashTable(const size_t entries)
+        : table(std::make_unique<std::atomic<uint64_t>[]>(std::bit_floor(std::max<size_t>(entries, 1)))),
+          mask(std::bit_floor(std::max<size_t>(entries, 1)) - 1)
+    {
+        clear();
+    }
+
+    PawnScore PawnHashTable::probe(const Position& pos)
+    {
+        // A pawnless position hashes to 0 and matches the empty entry, whose
+        // zero score is also the right answer
+        const auto key = (uint32_t)(pos.pawn_hash >> 32);
+        std::atomic<uint64_t>& slot = table[pos.pawn_hash & mask];
+
+        const uint64_t entry = slot.load(std::memory_order_relaxed);
+        if ((uint32_t)(entry >> 32) == key)
+            return { (int16_t)(uint16_t)(entry >> 16), (int16_t)(uint16_t)entry };
+
+        const PawnScore score = evaluate_pawn_structure(pos);
+        slot.store((uint64_t)key << 32 | (uint64_t)(uint16_t)score.midgame << 16 | (uint16_t)score.endgame,
+                   std::memory_order_relaxed);
+        return score;
+    }
+
+    void PawnHashTable::clear()
+    {
+        for (size_t i = 0; i <= mask; ++i)
+            table[i].store(0, std::memory_order_relaxed);
+    }
+
+}  // namespace chess
@@ -0,0 +1,136 @@
+#include "chess/Perft.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <thread>
+
+namespace chess {
+
+namespace {
+
+/// Lock-free (hash, depth) -> node count cache shared by all perft threads.
+/// Each slot stores `key ^ count` next to the count, so a read torn by a
+/// concurrent store fails verification and counts as a miss.
+class PerftHash {
+private:
+    struct Slot {
+        std::atomic<uint64_t> check{0};
+        std::atomic<uint64_t> count{0};
+    };
+
+    std::unique_ptr<Slot[]> table;
+    size_t mask = 0;
+
+    static uint64_t key(const Hash h, const int depth) {
+        return h ^ ((uint64_t)depth * 0x9E3779B97F4A7C15ULL);
+    }
+
+public:
+    explicit PerftHash(const size_t mb_size) {
+        if (mb_size == 0) return;
+
+        size_t entry_count = (mb_size * 1024 * 1024) / sizeof(Slot);
+        entry_count = 1ULL << (63 - __builtin_clzll(entry_count | 1));
+        table = std::make_unique<Slot[]>(entry_count);
+        mask = entry_count - 1;
+    }
+
+    [[nodiscard]] bool enabled() const { return table != nullptr; }
+
+    [[nodiscard]] std::optional<uint64_t> probe(const Hash h, const int depth) const {
+        const uint64_t k = key(h, depth);
+        const Slot& slot = table[k & mask];
+        const uint64_t count = slot.count.load(std::memory_order_relaxed);
+        if ((slot.check.load(std::memory_order_relaxed) ^ count) != k)
+            return std::nullopt;
+        return count;
+    }
+
+    void store(const Hash h, const int depth, const uint64_t count) {
+        const uint64_t k = key(h, depth);
+        Slot& slot = table[k & mask];
+        slot.check.store(k ^ count, std::memory_order_relaxed);
+        slot.count.store(count, std::memory_order_relaxed);
+    }
+};
+
+uint64_t count_nodes(const Board& board, const int depth, PerftHash& hash) {
+    MoveList moves;
+    board.generate_moves(moves);
+
+    // Bulk counting: every legal move at the last ply is one leaf
+    if (depth == 1)
+        return moves.size();
+
+    if (hash.enabled()) {
+        if (const auto cached = hash.probe(board.zobrist_hash(), depth))
+            return *cached;
+    }
+
+    uint64_t nodes = 0;
+    for (const auto move : moves) {
+        board.make_move_unchecked(move);
+        nodes += count_nodes(board, depth - 1, hash);
+        board.undo_move_unchecked();
+    }
+
+    if (hash.enabled())
+        hash.store(board.zobrist_hash(), depth, nodes);
+
+    return nodes;
+}
+
+}  // namespace
+
+std::vector<std::pair<Move, uint64_t>> divide(const Board& board, const int depth, const PerftConfig& config) {
+    std::vector<std::pair<Move, uint64_t>> results;
+    if (depth <= 0)
+        return results;
+
+    MoveList moves;
+    board.generate_moves(moves);
+    for (const auto move : moves)
+        results.emplace_back(move, 1);
+
+    if (depth == 1 || moves.empty())
+        return results;
+
+    PerftHash hash(config.hash_mb);
+
+    // Threads pull root moves off a shared counter, each on its own copy of the board
+    std::atomic<size_t> next_move = 0;
+    const auto work = [&] {
+        const Board local(board);
+        for (size_t i; (i = next_move.fetch_add(1, std::memory_order_relaxed)) < results.size();) {
+            local.make_move_unchecked(results[i].first);
+            results[i].second = count_nodes(local, depth - 1, hash);
+            local.undo_move_unchecked();
+        }
+    };
+
+    const size_t thread_count = std::clamp<size_t>(config.threads, 1, results.size());
+    std::vector<std::thread> helpers;
+    for (size_t i = 1; i < thread_count; ++i)
+        helpers.emplace_back(work);
+
+    work();
+    for (auto& helper : helpers)
+        helper.join();
+
+    return results;
+}
+
+uint64_t perft(const Board& board, const int depth, const PerftConfig& config) {
+    if (depth <= 0)
+        return 1;
+
+    uint64_t nodes = 0;
+    for (const auto& count : divide(board, depth, config) | std::views::values)
+        nodes += count;
+    return nodes;
+}
+
+}  // namespace chess
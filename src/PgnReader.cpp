@@ -0,0 +1,162 @@
+#include "chess/PgnReader.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+namespace chess
+{
+    namespace
+    {
+        constexpr std::string_view WHITESPACE = " \t\r\n";
+
+        /// Top-level tokens of PGN movetext. Comments ({...} and ; to end of
+        /// line), variations, NAGs and move numbers are skipped, so what comes
+        /// out is SAN moves and the game result, or the '[' of the next game's tags
+        class MovetextLexer {
+        public:
+            enum class Kind { MOVE, RESULT, TAGS, END };
+
+            struct Token {
+                Kind kind;
+                std::string_view text;
+            };
+
+            explicit MovetextLexer(const std::string_view text) : text(text) {}
+
+            Token next() {
+                int depth = 0;  // Variation nesting
+                while (pos < text.size()) {
+                    const char c = text[pos];
+                    if (WHITESPACE.find(c) != std::string_view::npos) { ++pos; continue; }
+                    if (c == '{') { pos = std::min(text.find('}', pos), text.size() - 1) + 1; continue; }
+                    if (c == ';') { pos = std::min(text.find('\n', pos), text.size() - 1) + 1; continue; }
+                    if (c == '(') { ++depth; ++pos; continue; }
+                    if (c == ')') { depth = std::max(depth - 1, 0); ++pos; continue; }
+                    if (c == '[' && depth == 0) return { Kind::TAGS, {} };
+                    if (c == '[' || c == ']' || c == '}') { ++pos; continue; }  // Stray closers
+
+                    const size_t end = std::min(text.find_first_of(" \t\r\n{}();[]", pos), text.size());
+                    // Every delimiter is consumed above, so a word is never empty
+                    assert(end > pos);
+                    std::string_view word = text.substr(pos, end - pos);
+                    pos = end;
+                    if (depth > 0 || word.front() == '$') continue;
+
+                    if (word == "1-0" || word == "0-1" || word == "1/2-1/2" || word == "*")
+                        return { Kind::RESULT, word };
+
+                    // Move numbers ("12." and "12...") may be glued to the move after them;
+                    // castling written with zeros is a move, not a number
+                    if (word.front() >= '0' && word.front() <= '9') {
+                        const size_t digits = word.find_first_not_of("0123456789");
+                        if (digits == std::string_view::npos) continue;
+                        if (word[digits] == '.') {
+                            const size_t move = word.find_first_not_of('.', digits);
+                            if (move == std::string_view::npos) continue;
+                            word = word.substr(move);
+                        }
+                    }
+                    return { Kind::MOVE, word };
+                }
+                return { Kind::END, {} };
+            }
+
+            [[nodiscard]] size_t offset() const { return pos; }
+
+        private:
+            std::string_view text;
+            size_t pos = 0;
+        };
+    }
+
+    std::string_view PgnGame::tag(const std::string_view name) const
+    {
+        const auto found = std::ranges::find(tags, name, &PgnTag::name);
+        return found == tags.end() ? std::string_view() : found->value;
+    }
+
+    PgnReader::PgnReader(const std::string_view text) : text(text) {}
+
+    PgnReader PgnReader::open(const std::string& path)
+    {
+        internal::MappedFile mapped(path);
+        PgnReader reader({ reinterpret_cast<const char*>(mapped.data()), mapped.size() });
+        reader.file = std::move(mapped);
+        return reader;
+    }
+
+    bool PgnReader::next(PgnGame& game)
+    {
+        game.tags.clear();
+        game.movetext = {};
+        game.result = {};
+
+        const auto skip_whitespace = [this] {
+            pos = std::min(text.find_first_not_of(WHITESPACE, pos), text.size());
+        };
+
+        skip_whitespace();
+        if (pos == text.size())
+            return false;
+
+        // Tag pairs: [Name "value"], the value may contain escaped quotes
+        while (pos < text.size() && text[pos] == '[') {
+            const size_t name_start = text.find_first_not_of(WHITESPACE, pos + 1);
+            const size_t open_quote = text.find('"', pos);
+            const size_t line_end = std::min(text.find('\n', pos), text.size());
+            if (name_start == std::string_view::npos || open_quote >= line_end)
+                throw std::invalid_argument("Unterminated PGN tag at byte " + std::to_string(pos));
+
+            size_t close_quote = open_quote + 1;
+            while (close_quote < text.size() && text[close_quote] != '"')
+                close_quote += text[close_quote] == '\\' ? 2 : 1;
+            const size_t close_bracket = text.find(']', std::min(close_quote, text.size()));
+            if (close_quote >= line_end || close_bracket == std::string_view::npos)
+                throw std::invalid_argument("Unterminated PGN tag at byte " + std::to_string(pos));
+
+            const size_t name_end = std::min(text.find_first_of(" \t\"", name_start), open_quote);
+            game.tags.push_back({ text.substr(name_start, name_end - name_start),
+                                  text.substr(open_quote + 1, close_quote - open_quote - 1) });
+            pos = close_bracket + 1;
+            skip_whitespace();
+        }
+
+        // Movetext runs to the result, or to the next game's tags if it has none
+        const std::string_view rest = text.substr(pos);
+        MovetextLexer lexer(rest);
+        for (;;) {
+            const MovetextLexer::Token token = lexer.next();
+            if (token.kind == MovetextLexer::Kind::RESULT) game.result = token.text;
+            if (token.kind != MovetextLexer::Kind::MOVE) break;
+        }
+
+        game.movetext = rest.substr(0, lexer.offset());
+        game.movetext = game.movetext.substr(0, game.movetext.find_last_not_of(WHITESPACE) + 1);
+        pos += lexer.offset();
+        return true;
+    }
+
+    size_t PgnReader::replay(const PgnGame& game, const Board& board,
+                             const std::function<void(const Board&, Move)>& on_move)
+    {
+        const std::string_view fen = game.tag("FEN");
+        if (fen.empty()) board.reset();
+        else board.load_fen(fen);
+        board.clear_history();
+
+        size_t played = 0;
+        MovetextLexer lexer(game.movetext);
+        for (auto token = lexer.next(); token.kind == MovetextLexer::Kind::MOVE; token = lexer.next()) {
+            const Move move = board.parse_san(token.text);
+            if (on_move) on_move(board, move);
+
+            if (played > 0 && played % MAX_GAME_PLIES == 0)
+                board.clear_history();
+            board.make_move_unchecked(move);
+            ++played;
+        }
+        return played;
+    }
+
+}  // namespace chess
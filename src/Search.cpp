@@ -2,10 +2,15 @@
 #include "chess/ZobristHasher.hpp"
 #include "chess/TranspositionTable.hpp"
 #include "chess/Eval.hpp"
+#include "chess/TimeManager.hpp"
 #include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
 #include <cstring>
-#include <iostream>
+#include <random>
 #include <ranges>
+#include <thread>
 
 #include "chess/PieceSquareTables.hpp"
 #include "chess/internal/Bitboard.hpp"
@@ -36,22 +41,25 @@ public:
 
 class KillerMoves {
 private:
-    static constexpr int MAX_DEPTH = 32;
-    std::array<std::array<Move, 2>, MAX_DEPTH> killers;
+    std::array<std::array<Move, 2>, MAX_PLY> killers;
 
 public:
     KillerMoves() { clear(); }
 
-    void store(const Depth d, const Move m) {
-        if (d < MAX_DEPTH && killers[d][0] != m) {
-            killers[d][1] = killers[d][0];
-            killers[d][0] = m;
+    void store(const int ply, const Move m) {
+        if (ply < MAX_PLY && killers[ply][0] != m) {
+            killers[ply][1] = killers[ply][0];
+            killers[ply][0] = m;
         }
     }
 
-    [[nodiscard]] bool is_killer(const Depth d, const Move m) const {
-        if (d >= MAX_DEPTH) return false;
-        return killers[d][0] == m || killers[d][1] == m;
+    [[nodiscard]] bool is_killer(const int ply, const Move m) const {
+        if (ply >= MAX_PLY) return false;
+        return killers[ply][0] == m || killers[ply][1] == m;
+    }
+
+    [[nodiscard]] std::array<Move, 2> get(const int ply) const {
+        return ply < MAX_PLY ? killers[ply] : std::array<Move, 2>{};
     }
 
     void clear() {
@@ -59,18 +67,310 @@ public:
     }
 };
 
-struct SearchStats {
-    uint64_t nodes = 0;
-    uint64_t tt_hits = 0;
-    uint64_t cutoffs = 0;
-    std::chrono::high_resolution_clock::time_point start_time;
+/// Moves the capture generator emits (captures, en passant, queen promotions)
+bool is_tactical(const Move m) {
+    return m.is_capture() || m.is_en_passant() || (m.is_promotion() && m.promotion() == PieceType::QUEEN);
+}
+
+/// Material the move takes off the board (the pawn behind the target for en passant)
+int captured_value(const Board& board, const Move m) {
+    if (m.is_en_passant()) return (int)PIECE_VALUES[(int)PieceType::PAWN];
+    const Piece victim = board.piece_at(m.to());
+    return victim == Piece::NONE ? 0 : (int)PIECE_VALUES[(int)get_piece_type(victim)];
+}
+
+/// MVV/LVA: most valuable victim first, cheapest attacker breaking ties
+int capture_score(const Board& board, const Move m) {
+    const int attacker_value = (int)PIECE_VALUES[(int)get_piece_type(board.piece_at(m.from()))];
+    const int promotion_value = m.is_promotion() ? (int)PIECE_VALUES[(int)m.promotion()] : 0;
+
+    return (captured_value(board, m) + promotion_value) * 10 - attacker_value;
+}
+
+/// Delta pruning slack: a capture must be able to bring the score this close to alpha
+constexpr Score DELTA_MARGIN = 200;
+
+/// Wider than any reachable score, mates included
+constexpr Score INFINITE_SCORE = 50000;
+
+/// First aspiration half-width; doubled on every fail until it gives way to a full window
+constexpr Score ASPIRATION_WINDOW = 40;
+
+/// Reverse futility: per-ply margin by which static eval must clear beta
+constexpr Score REVERSE_FUTILITY_MARGIN = 120;
+
+/// Futility: margin by remaining depth within which a quiet move might still reach alpha
+constexpr std::array<Score, 3> FUTILITY_MARGIN = { 0, 200, 350 };
+
+/// Late move reductions by [depth][moves searched], growing with the log of both
+const auto LMR_TABLE = [] {
+    std::array<std::array<int8_t, 64>, MAX_DEPTH + 1> table{};
+    for (int d = 1; d <= MAX_DEPTH; ++d)
+        for (int m = 1; m < 64; ++m)
+            table[d][m] = (int8_t)(0.75 + std::log(d) * std::log(m) / 2.25);
+    return table;
+}();
+
+/// Tablebase scores are exact: stored this much deeper than the probing node's depth
+constexpr int TABLEBASE_DEPTH_BONUS = 6;
+
+/// Mate scores count plies from the root; the table stores them counted from the node instead
+Score score_to_tt(const Score s, const int ply) {
+    return is_mate(s) ? (s > 0 ? s + ply : s - ply) : s;
+}
+
+Score score_from_tt(const Score s, const int ply) {
+    return is_mate(s) ? (s > 0 ? s - ply : s + ply) : s;
+}
+
+/// Anything beyond pawns and king: without it, passing may be the best move (zugzwang)
+bool has_non_pawn_material(const Board& board) {
+    const Color us = board.side_to_move();
+    const int pawns = std::popcount(board.pieces(us, PieceType::PAWN));
+    return board.position().material[(int)us] > pawns * (Score)PIECE_VALUES[(int)PieceType::PAWN];
+}
+
+#ifdef CHESS_NO_SEARCH_STATS
+constexpr bool COLLECT_STATS = false;
+#else
+constexpr bool COLLECT_STATS = true;
+#endif
+
+/// One thread's counters (see SearchStats). Each is written only by its owner,
+/// with a relaxed load/store pair instead of a locked increment, and read by the
+/// main thread when it reports. Nodes are always counted: limits depend on them
+struct ThreadStats {
+    using Counter = std::atomic<uint64_t>;
+
+    Counter nodes = 0;
+    Counter qnodes = 0;
+    Counter tt_probes = 0;
+    Counter tt_hits = 0;
+    Counter tt_cutoffs = 0;
+    Counter tt_collisions = 0;
+    Counter tb_hits = 0;
+    Counter cutoffs = 0;
+    Counter first_move_cutoffs = 0;
+    std::atomic<int> seldepth = 0;
+    int until_time_check = 0;         // Nodes left before the next clock poll
+
+    static void bump(Counter& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void count_node() { bump(nodes); }
+
+    void count(Counter& counter) {
+        if constexpr (COLLECT_STATS) bump(counter);
+    }
+
+    void reach(const int ply) {
+        if constexpr (COLLECT_STATS)
+            if (ply > seldepth.load(std::memory_order_relaxed)) seldepth.store(ply, std::memory_order_relaxed);
+    }
 
-    [[nodiscard]] double elapsed_seconds() const {
-        const auto now = std::chrono::high_resolution_clock::now();
-        return std::chrono::duration<double>(now - start_time).count();
+    void add_to(SearchStats& total) const {
+        const auto get = [](const Counter& counter) { return counter.load(std::memory_order_relaxed); };
+        total.nodes += get(nodes);
+        total.qnodes += get(qnodes);
+        total.tt_probes += get(tt_probes);
+        total.tt_hits += get(tt_hits);
+        total.tt_cutoffs += get(tt_cutoffs);
+        total.tt_collisions += get(tt_collisions);
+        total.tb_hits += get(tb_hits);
+        total.cutoffs += get(cutoffs);
+        total.first_move_cutoffs += get(first_move_cutoffs);
+        total.seldepth = std::max(total.seldepth, seldepth.load(std::memory_order_relaxed));
+    }
+};
+
+/// Triangular PV table: line[ply] holds the best line found from ply onward.
+/// A node that raises alpha records its move followed by its child's line, so
+/// the principal variation comes out of the search itself, not a TT walk.
+struct PVTable {
+    std::array<std::array<Move, MAX_PLY>, MAX_PLY> line;
+    std::array<int, MAX_PLY> length{};
+
+    void clear(const int ply) { length[ply] = ply; }
+
+    void update(const int ply, const Move m) {
+        line[ply][ply] = m;
+        const int child = ply + 1;
+        if (child >= MAX_PLY) {
+            length[ply] = child;
+            return;
+        }
+        const int end = std::max(length[child], child);
+        std::copy(line[child].begin() + child, line[child].begin() + end, line[ply].begin() + child);
+        length[ply] = end;
+    }
+};
+
+/// Per-thread search state. Lazy SMP threads share only the transposition
+/// table and the stop flag; each one searches its own copy of the board.
+struct SearchWorker {
+    int id;
+    Board board;
+    HistoryHeuristic history;
+    KillerMoves killers;
+    ThreadStats stats;
+    PVTable pv;
+    std::vector<RootMove> root_moves;   // Kept across iterations for ordering by subtree size
+
+    SearchWorker(const int id, const Board& board, std::shared_ptr<const NnueNetwork> network)
+        : id(id), board(board) {
+        // Each worker keeps its own accumulator stack for the shared network
+        if (network) this->board.attach_network(std::move(network));
     }
 };
 
+// ============================================================================
+// Staged Move Picker
+// ============================================================================
+
+/// Hands out moves one at a time in search order:
+///     TT move -> winning/equal captures (MVV/LVA) -> killers for this ply
+///     -> quiets (history) -> losing captures (SEE < 0)
+/// Each list is generated only when the stage before it is used up, and moves are
+/// picked by lazy selection over MoveList's scores, so an early cutoff skips
+/// generating and scoring everything after it.
+class MovePicker {
+public:
+    /// All legal moves; without ordering they come in generation order
+    MovePicker(const SearchWorker& worker, const Move tt_move, const int ply, const bool ordered)
+        : worker(worker), tt_move(tt_move), ordered(ordered),
+          stage(ordered ? Stage::TT_MOVE : Stage::INIT_ALL) {
+        if (ordered) killers = worker.killers.get(ply);
+    }
+
+    /// Tactical moves only (quiescence); prune_losing drops captures that lose material by SEE
+    MovePicker(const SearchWorker& worker, const bool ordered, const bool prune_losing)
+        : worker(worker), ordered(ordered), captures_only(true), prune_losing(prune_losing),
+          stage(Stage::INIT_CAPTURES) {}
+
+    /// Next move to search, or Move() once every stage is exhausted
+    Move next();
+
+    /// Was the TT move dropped as illegal here? Its entry was another position's
+    [[nodiscard]] bool rejected_tt_move() const { return tt_rejected; }
+
+private:
+    enum class Stage : uint8_t {
+        TT_MOVE, INIT_CAPTURES, CAPTURES, KILLERS, INIT_QUIETS, QUIETS, BAD_CAPTURES, INIT_ALL, ALL, DONE
+    };
+
+    const SearchWorker& worker;
+    Move tt_move;
+    std::array<Move, 2> killers{};
+    bool ordered;
+    bool captures_only = false;
+    bool prune_losing = false;
+    Stage stage;
+    bool tt_rejected = false;
+
+    MoveList moves;
+    size_t index = 0;
+    size_t killer_index = 0;
+
+    // Captures failing SEE, held back until after the quiets
+    std::array<Move, 64> bad_captures{};
+    size_t bad_count = 0;
+    size_t bad_index = 0;
+
+    [[nodiscard]] bool already_tried(const Move m) const {
+        return m == tt_move || (!captures_only && (m == killers[0] || m == killers[1]));
+    }
+};
+
+Move MovePicker::next() {
+    const Board& board = worker.board;
+
+    switch (stage) {
+    case Stage::TT_MOVE:
+        stage = Stage::INIT_CAPTURES;
+        if (tt_move != Move() && board.is_generated_move(tt_move))
+            return tt_move;
+        tt_rejected = tt_move != Move();
+        tt_move = Move();
+        [[fallthrough]];
+
+    case Stage::INIT_CAPTURES:
+        board.generate_captures(moves);
+        if (ordered) {
+            for (size_t i = 0; i < moves.size(); ++i)
+                moves.set_score(i, capture_score(board, moves[i]));
+        }
+        index = 0;
+        stage = Stage::CAPTURES;
+        [[fallthrough]];
+
+    case Stage::CAPTURES:
+        while (index < moves.size()) {
+            const Move m = ordered ? moves.pick_best(index) : moves[index];
+            ++index;
+            if (m == tt_move) continue;
+
+            // Held back only where quiets follow; quiescence has nothing to put first
+            if ((prune_losing || (ordered && !captures_only)) && !board.see_ge(m, 0)) {
+                if (prune_losing) continue;
+                if (bad_count < bad_captures.size()) {
+                    bad_captures[bad_count++] = m;
+                    continue;
+                }
+            }
+            return m;
+        }
+        if (captures_only) break;
+        stage = Stage::KILLERS;
+        [[fallthrough]];
+
+    case Stage::KILLERS:
+        while (killer_index < killers.size()) {
+            const Move killer = killers[killer_index++];
+            if (killer != Move() && killer != tt_move && !is_tactical(killer) && board.is_generated_move(killer))
+                return killer;
+        }
+        stage = Stage::INIT_QUIETS;
+        [[fallthrough]];
+
+    case Stage::INIT_QUIETS:
+        board.generate_quiets(moves);
+        for (size_t i = 0; i < moves.size(); ++i)
+            moves.set_score(i, worker.history.get_score(moves[i].from(), moves[i].to()));
+        index = 0;
+        stage = Stage::QUIETS;
+        [[fallthrough]];
+
+    case Stage::QUIETS:
+        while (index < moves.size()) {
+            const Move m = moves.pick_best(index++);
+            if (!already_tried(m)) return m;
+        }
+        stage = Stage::BAD_CAPTURES;
+        [[fallthrough]];
+
+    case Stage::BAD_CAPTURES:
+        if (bad_index < bad_count) return bad_captures[bad_index++];
+        break;
+
+    case Stage::INIT_ALL:
+        board.generate_moves(moves);
+        index = 0;
+        stage = Stage::ALL;
+        [[fallthrough]];
+
+    case Stage::ALL:
+        if (index < moves.size()) return moves[index++];
+        break;
+
+    case Stage::DONE:
+        break;
+    }
+
+    stage = Stage::DONE;
+    return {};
+}
+
 // ============================================================================
 // Engine::Impl
 // ============================================================================
@@ -78,103 +378,137 @@ struct SearchStats {
 class Engine::Impl {
 public:
     SearchConfig config;
-    HistoryHeuristic history;
-    KillerMoves killers;
-    TranspositionTable ttable;
-    PieceSquareTables pst;
+    std::shared_ptr<TranspositionTable> table;     // Own, or shared with other engines
+    TranspositionTable* ttable;                    // table.get(), for the search's hot paths
     Evaluator evaluator;
 
-    SearchStats stats{};
-    bool stop_requested = false;
+    std::atomic<bool> stop_requested = false;
+    TimeManager timer;
+    std::mt19937_64 book_rng{std::random_device{}()};
+
+    // Main thread's line from the last completed iteration, and the position it is for
+    std::vector<Move> last_pv;
+    Hash last_root = 0;
 
     Impl();
     explicit Impl(const SearchConfig& cfg);
+    Impl(const SearchConfig& cfg, std::shared_ptr<TranspositionTable> shared);
 
+    std::optional<SearchResult> probe_book(const Board& board);
     SearchResult search_iterative(Board& board, std::chrono::milliseconds time_limit);
+    SearchResult search_clock(Board& board, const TimeControl& time_control);
     SearchResult search_fixed_depth(Board& board, Depth max_depth);
 
-    Score negamax(Board& board, Depth depth, Score alpha, Score beta);
-    Score quiescence(Board& board, Score alpha, Score beta);
+    Score search_root(SearchWorker& worker, Depth depth, Score alpha, Score beta, Move& best_move);
+    Score search_aspiration(SearchWorker& worker, Depth depth, Score previous, Move& best_move);
+    Score negamax(SearchWorker& worker, Depth depth, Score alpha, Score beta, int ply, bool null_allowed = true);
+    Score quiescence(SearchWorker& worker, Score alpha, Score beta, int ply);
     Score evaluate(const Board& board);
 
-    void order_moves(MoveList& moves, const Board& board, Move ttmove) const;
+    void order_moves(const SearchWorker& worker, MoveList& moves, Move ttmove) const;
 
 private:
-    Move best_move_at_depth = Move();
+    SearchResult run_search(const Board& board, int max_depth);
+    void helper_search(SearchWorker& worker, int max_depth);
+    void init_root_moves(SearchWorker& worker) const;
+    [[nodiscard]] std::optional<Score> probe_tablebase(const Board& board, int ply) const;
+
+    [[nodiscard]] bool stopped() const { return stop_requested.load(std::memory_order_relaxed); }
+
+    // Count a node; the main thread raises the stop flag at its node limit, and
+    // every time_check_nodes polls the clock and the stop token to do so once the
+    // hard deadline has passed or the caller has cancelled
+    void visit_node(SearchWorker& worker, const int ply) {
+        worker.stats.count_node();
+        worker.stats.reach(ply);
+        if (worker.id != 0) return;
+
+        if (config.node_limit != 0 && worker.stats.nodes.load(std::memory_order_relaxed) >= config.node_limit)
+            stop_requested.store(true, std::memory_order_relaxed);
+        if (--worker.stats.until_time_check <= 0) {
+            worker.stats.until_time_check = config.time_check_nodes;
+            if (timer.hard_expired() || config.stop_token.stop_requested())
+                stop_requested.store(true, std::memory_order_relaxed);
+        }
+    }
 
-    [[nodiscard]] int move_score(const Move& move, const Board& board, Move ttmove, Depth depth) const;
+    // Make/unmake for a move from the legal generator; copy-make mode undoes it by
+    // restoring the snapshot taken beforehand instead of reversing the move
+    void make_move(SearchWorker& worker, const Move move, Position& snapshot) const {
+        if (config.use_copy_make) snapshot = worker.board.position();
+        worker.board.make_move_unchecked(move);
+    }
+
+    void unmake_move(SearchWorker& worker, const Position& snapshot) const {
+        if (config.use_copy_make) worker.board.undo_move_to(snapshot);
+        else worker.board.undo_move_unchecked();
+    }
+
+    [[nodiscard]] int move_score(const SearchWorker& worker, const Move& move, Move ttmove, int ply) const;
 };
 
 // ============================================================================
 // Engine::Impl Implementation
 // ============================================================================
 
-Engine::Impl::Impl() : ttable(config.tt_size_mb), evaluator(pst) {}
+Engine::Impl::Impl() : Impl(SearchConfig()) {}
 
-Engine::Impl::Impl(const SearchConfig& cfg) : config(cfg) , ttable(cfg.tt_size_mb), evaluator(pst) {}
+Engine::Impl::Impl(const SearchConfig& cfg)
+    : Impl(cfg, std::make_shared<TranspositionTable>(cfg.tt_size_mb)) {}
+
+Engine::Impl::Impl(const SearchConfig& cfg, std::shared_ptr<TranspositionTable> shared)
+    : config(cfg), table(std::move(shared)), ttable(table.get()) {}
 
 // ============================================================================
 // Move Ordering - Critical for Alpha-Beta Efficiency
 // ============================================================================
 
-void Engine::Impl::order_moves(MoveList& moves, const Board& board, const Move ttmove) const {
-    // Score moves for ordering
-    std::vector<std::pair<int, Move>> scored;
-    scored.reserve(moves.size());
-
-    for (auto& move : moves) {
-        int score = move_score(move, board, ttmove, 0);
-        scored.emplace_back(score, move);
-    }
-
-    // Sort by score (descending)
-    std::ranges::sort(scored,
-                      [](const auto& a, const auto& b) { return a.first > b.first; });
+void Engine::Impl::order_moves(const SearchWorker& worker, MoveList& moves, const Move ttmove) const {
+    // Score in place, then selection-sort by score (descending)
+    for (size_t i = 0; i < moves.size(); ++i)
+        moves.set_score(i, move_score(worker, moves[i], ttmove, 0));
 
-    // Rebuild moves list in sorted order
-    moves.clear();
-    for (const auto& move : scored | std::views::values) {
-        moves.add(move);
-    }
+    for (size_t i = 0; i < moves.size(); ++i)
+        moves.pick_best(i);
 }
 
-int Engine::Impl::move_score(const Move& move, const Board& board, const Move ttmove, const Depth depth) const {
+int Engine::Impl::move_score(const SearchWorker& worker, const Move& move, const Move ttmove, const int ply) const {
     // Transposition table move - highest priority
     if (move == ttmove) return 1000000;
 
-    // Captures - MVV/LVA scoring
-    if (move.flag() == MoveFlag::CAPTURE) {
-        const Piece victim = board.piece_at(move.to());
-        const Piece attacker = board.piece_at(move.from());
-
-        const int victim_value = PIECE_VALUES[(int)get_piece_type(victim)];
-        const int attacker_value = PIECE_VALUES[(int)get_piece_type(attacker)];
-
-        return 500000 + (victim_value * 10 - attacker_value);
-    }
+    // Captures - MVV/LVA scoring; those losing material by SEE go after the quiets
+    if (is_tactical(move))
+        return (worker.board.see_ge(move, 0) ? 500000 : -500000) + capture_score(worker.board, move);
 
     // Killer moves
-    if (killers.is_killer(depth, move)) return 90000;
+    if (worker.killers.is_killer(ply, move)) return 90000;
 
     // Quiet moves - history heuristic
-    return history.get_score(move.from(), move.to());
+    return worker.history.get_score(move.from(), move.to());
 }
 
 // ============================================================================
 // Quiescence Search - Handle Tactical Positions
 // ============================================================================
 
-Score Engine::Impl::quiescence(Board& board, Score alpha, const Score beta) {
-    if (stop_requested) return 0;
+Score Engine::Impl::quiescence(SearchWorker& worker, Score alpha, const Score beta, const int ply) {
+    worker.pv.clear(ply);
+    if (stopped()) return 0;
+
+    Board& board = worker.board;
+    visit_node(worker, ply);
+    worker.stats.count(worker.stats.qnodes);
 
-    stats.nodes++;
+    if (ply >= MAX_PLY - 1)
+        return evaluate(board);
 
-    // Check terminal states
-    if (board.is_checkmate())
-        return board.side_to_move() == Color::WHITE ? -CHECKMATE : CHECKMATE;
+    // Only capture moves in quiescence, best victims first; SEE-losing ones only without qsearch pruning
+    MovePicker picker(worker, config.use_move_ordering, config.use_qsearch_pruning);
+    Move capture = picker.next();
 
-    if (board.is_stalemate())
-        return STALEMATE;
+    // Check terminal states: any capture already proves a legal move exists
+    if (capture == Move() && !board.has_legal_move())
+        return board.is_in_check() ? -CHECKMATE + ply : STALEMATE;
 
     // Stand-pat: position value without any moves
     const Score stand_pat = evaluate(board);
@@ -185,16 +519,18 @@ Score Engine::Impl::quiescence(Board& board, Score alpha, const Score beta) {
     if (alpha < stand_pat)
         alpha = stand_pat;
 
-    // Only generate capture moves in quiescence
-    MoveList captures;
-    board.generate_captures(captures);
-
     // Try each capture
-    for (const auto capture : captures) {
-        board.make_move(capture);
+    Position snapshot;
+    for (; capture != Move(); capture = picker.next()) {
+        // Delta pruning: even winning the victim for free would not lift the score to alpha
+        if (config.use_qsearch_pruning && !capture.is_promotion() &&
+            stand_pat + captured_value(board, capture) + DELTA_MARGIN <= alpha)
+            continue;
+
+        make_move(worker, capture, snapshot);
 
-        const Score score = -quiescence(board, -beta, -alpha);
-        board.undo_move();
+        const Score score = -quiescence(worker, -beta, -alpha, ply + 1);
+        unmake_move(worker, snapshot);
 
         if (score >= beta) {
             return beta;
@@ -211,205 +547,501 @@ Score Engine::Impl::quiescence(Board& board, Score alpha, const Score beta) {
 // Main Search - Negamax with Alpha-Beta Pruning
 // ============================================================================
 
-Score Engine::Impl::negamax(Board& board, Depth depth, Score alpha, const Score beta) {
-    if (stop_requested) return 0;
+Score Engine::Impl::negamax(SearchWorker& worker, Depth depth, Score alpha, const Score beta,
+                            const int ply, const bool null_allowed) {
+    worker.pv.clear(ply);
+    if (stopped()) return 0;
 
-    // Transposition table lookup
-    const auto tt_entry = ttable.lookup(board.zobrist_hash(), depth);
+    Board& board = worker.board;
+    const Score original_alpha = alpha;
+    const bool pv_node = beta - alpha > 1;
+
+    // Transposition table lookup: a deep enough entry may cut, any entry supplies a move
+    const auto tt_entry = ttable->lookup(board.zobrist_hash(), 0);
+    worker.stats.count(worker.stats.tt_probes);
+    if (tt_entry) worker.stats.count(worker.stats.tt_hits);
     if (tt_entry && tt_entry->depth >= depth) {
-        stats.tt_hits++;
-        return tt_entry->score;
+        const Score tt_score = score_from_tt(tt_entry->score, ply);
+        if (tt_entry->flag == EXACT ||
+            (tt_entry->flag == LOWER_BOUND && tt_score >= beta) ||
+            (tt_entry->flag == UPPER_BOUND && tt_score <= alpha)) {
+            worker.stats.count(worker.stats.tt_cutoffs);
+            return tt_score;
+        }
     }
 
-    stats.nodes++;
+    visit_node(worker, ply);
 
-    // Terminal states
-    if (board.is_checkmate())
-        return -CHECKMATE;
-
-    if (board.is_stalemate() || board.is_50_move_draw())
+    if (board.is_50_move_draw())
         return 0;
 
+    if (ply >= MAX_PLY - 1)
+        return evaluate(board);
+
+    // Tablebase: an exact score, so it goes into the TT deeper than this search could reach
+    if (depth >= config.tablebase_probe_depth) {
+        if (const auto tb_score = probe_tablebase(board, ply)) {
+            worker.stats.count(worker.stats.tb_hits);
+            if (config.use_transposition_table)
+                ttable->store(board.zobrist_hash(), score_to_tt(*tb_score, ply),
+                              (Depth)std::min(depth + TABLEBASE_DEPTH_BONUS, MAX_DEPTH), EXACT, Move());
+            return *tb_score;
+        }
+    }
+
+    const bool in_check = board.is_in_check();
+
+    // Check extension: don't let a check push the reply over the horizon
+    if (in_check && config.use_check_extensions)
+        ++depth;
+
     // Depth limit - enter quiescence search
-    if (depth == 0) {
+    if (depth <= 0) {
         if (config.use_quiescence_search)
-            return quiescence(board, alpha, beta);
+            return quiescence(worker, alpha, beta, ply);
+        if (!board.has_legal_move())
+            return in_check ? -CHECKMATE + ply : STALEMATE;
         return evaluate(board);
     }
 
-    // Generate moves
-    MoveList moves;
-    board.generate_moves(moves);
+    // Static pruning at nodes no one expects to be exact
+    Score static_eval = 0;
+    if (!pv_node && !in_check) {
+        static_eval = evaluate(board);
+
+        // Reverse futility: far enough above beta that a shallow search won't come back down
+        if (config.use_futility_pruning && depth <= 3 && !is_mate(beta) &&
+            static_eval - REVERSE_FUTILITY_MARGIN * depth >= beta)
+            return static_eval;
+
+        // Null move: if passing still fails high, a real move almost certainly does too
+        if (config.use_null_move_pruning && null_allowed && depth >= 3 && static_eval >= beta &&
+            !is_mate(beta) && has_non_pawn_material(board)) {
+            const Depth reduction = (Depth)(3 + depth / 4);
+
+            board.make_null_move();
+            ttable->prefetch(board.zobrist_hash());
+            const Score score = -negamax(worker, (Depth)(depth - reduction), -beta, -beta + 1, ply + 1, false);
+            board.undo_null_move();
+
+            if (stopped()) return 0;
+            if (score >= beta)
+                return is_mate(score) ? beta : score;  // Unproven mates from a null line
+        }
+    }
 
-    assert(!moves.empty());  // Should have been caught by terminal state checks
+    // Futility: near the leaves, quiet moves can't lift a hopeless static eval to alpha
+    const bool futile = config.use_futility_pruning && !pv_node && !in_check && depth < (int)FUTILITY_MARGIN.size() &&
+                        !is_mate(alpha) && static_eval + FUTILITY_MARGIN[depth] <= alpha;
 
-    // Move ordering
-    Move ttmove = tt_entry ? tt_entry->best_move : Move();
-    if (config.use_move_ordering)
-        order_moves(moves, board, ttmove);
+    // Staged move picker: captures and quiets are generated only if earlier moves fail to cut
+    MovePicker picker(worker, tt_entry ? tt_entry->best_move : Move(), ply, config.use_move_ordering);
 
-    Score best_score = std::numeric_limits<Score>::max();
-    Move best_move = moves[0];
+    Score best_score = -CHECKMATE - 1;
+    Move best_move;
     int moves_searched = 0;
-    Flag flag = EXACT;
 
     // Try each move
-    for (const auto& move : moves) {
-        board.make_move(move);
+    Position snapshot;
+    for (Move move; (move = picker.next()) != Move();) {
+        const bool quiet = !is_tactical(move) && !move.is_promotion();
+        const bool killer = worker.killers.is_killer(ply, move);
 
-        // Recursively search
-        const Score score = -negamax(board, depth - 1, -beta, -alpha);
+        make_move(worker, move, snapshot);
+        const bool gives_check = board.is_in_check();
 
-        board.undo_move();
+        if (futile && moves_searched > 0 && quiet && !gives_check) {
+            unmake_move(worker, snapshot);
+            continue;
+        }
+
+        ttable->prefetch(board.zobrist_hash());
+
+        Score score;
+        if (moves_searched == 0) {
+            score = -negamax(worker, (Depth)(depth - 1), -beta, -alpha, ply + 1);
+        } else {
+            // Late move reduction: trust the picker's order and look at late quiet moves less deeply
+            int reduction = 0;
+            if (config.use_late_move_reductions && depth >= 3 && moves_searched >= 3 &&
+                quiet && !killer && !in_check && !gives_check) {
+                reduction = LMR_TABLE[std::min<int>(depth, MAX_DEPTH)][std::min(moves_searched, 63)];
+                if (pv_node) --reduction;
+                reduction = std::clamp(reduction, 0, depth - 2);
+            }
+
+            // PVS: prove the move can't beat alpha with a zero window, re-search if it does
+            const Score search_beta = config.use_pvs ? alpha + 1 : beta;
+            score = -negamax(worker, (Depth)(depth - 1 - reduction), -search_beta, -alpha, ply + 1);
+
+            if (reduction > 0 && score > alpha)
+                score = -negamax(worker, (Depth)(depth - 1), -search_beta, -alpha, ply + 1);
+
+            if (config.use_pvs && score > alpha && score < beta)
+                score = -negamax(worker, (Depth)(depth - 1), -beta, -alpha, ply + 1);
+        }
+
+        unmake_move(worker, snapshot);
 
         moves_searched++;
 
         if (score > best_score) {
             best_score = score;
             best_move = move;
-            flag = EXACT;
         }
 
-        if (best_score > alpha)
-        {
+        if (best_score > alpha) {
             alpha = best_score;
-            flag = LOWER_BOUND;
+            worker.pv.update(ply, move);
         }
 
         // Beta cutoff
         if (alpha >= beta) {
-            stats.cutoffs++;
-                flag = LOWER_BOUND;
+            worker.stats.count(worker.stats.cutoffs);
+            if (moves_searched == 1) worker.stats.count(worker.stats.first_move_cutoffs);
 
             // Update killer move
-            if (!move.is_capture())
-                killers.store(depth, move);
+            if (!is_tactical(move))
+                worker.killers.store(ply, move);
 
             break;
         }
     }
 
+    if (picker.rejected_tt_move())
+        worker.stats.count(worker.stats.tt_collisions);
+
+    // No legal moves: the picker's empty output is the terminal-state check
+    // (futility pruning always searches the first move, so this stays exact)
+    if (moves_searched == 0)
+        return in_check ? -CHECKMATE + ply : STALEMATE;
+
+    // An aborted subtree returned garbage; keep it out of the shared table
+    if (stopped()) return 0;
+
     // Update history for quiet moves
-    if (!best_move.is_capture() && moves_searched > 0)
-        history.store(best_move.from(), best_move.to(), depth);
+    if (!is_tactical(best_move))
+        worker.history.store(best_move.from(), best_move.to(), depth);
 
     // Store in transposition table
+    const Flag flag = best_score >= beta ? LOWER_BOUND
+                    : best_score > original_alpha ? EXACT
+                    : UPPER_BOUND;
     if (config.use_transposition_table)
-        ttable.store(board.zobrist_hash(), best_score, depth, flag, best_move);
+        ttable->store(board.zobrist_hash(), score_to_tt(best_score, ply), depth, flag, best_move);
 
     return best_score;
 }
 
 // ============================================================================
-// Iterative Deepening - Progressive Deepening with Time Management
+// Root Search - One Iteration Over All Root Moves
 // ============================================================================
 
-SearchResult Engine::Impl::search_iterative(Board& board, const std::chrono::milliseconds time_limit) {
-    stats.start_time = std::chrono::high_resolution_clock::now();
-    stop_requested = false;
+std::optional<Score> Engine::Impl::probe_tablebase(const Board& board, const int ply) const {
+    const Position& pos = board.position();
+    if (!config.tablebase || std::popcount(pos.occupancy_all) > config.tablebase->cardinality())
+        return std::nullopt;
 
-    SearchResult best_result;
-    best_result.best_move = Move();
-    best_result.score = 0;
-    best_result.depth = 0;
-    best_result.nodes_searched = 0;
+    const auto result = config.tablebase->probe(pos);
+    if (!result) return std::nullopt;
 
-    // Iterative deepening: search depth 1, 2, 3, ... until time runs out
-    for (int depth = 1; depth <= config.max_depth; ++depth) {
-        history.clear();
-        killers.clear();
+    // Distance to mate ignores the fifty-move rule; a mate the clock would call a draw is left to the search
+    if (result->wdl != Wdl::DRAW && pos.halfmove_clock + result->dtm > 100)
+        return std::nullopt;
 
-        // Alpha-beta window
-        Score alpha = -50000;
-        Score beta = 50000;
+    switch (result->wdl) {
+    case Wdl::WIN:  return CHECKMATE - (ply + result->dtm);
+    case Wdl::LOSS: return -CHECKMATE + ply + result->dtm;
+    default:        return STALEMATE;
+    }
+}
 
-        // Root search at this depth
-        MoveList moves;
-        board.generate_moves(moves);
+void Engine::Impl::init_root_moves(SearchWorker& worker) const {
+    MoveList moves;
+    worker.board.generate_moves(moves);
+    if (config.use_move_ordering)
+        order_moves(worker, moves, Move());
+
+    worker.root_moves.clear();
+    for (const Move move : moves)
+        worker.root_moves.push_back({move, -INFINITE_SCORE, 0});
+
+    // A root the tablebase covers keeps only the moves that hold its best outcome,
+    // the quickest mates when winning, so the search can't trade a win for a draw
+    if (worker.root_moves.empty() || !probe_tablebase(worker.board, 0)) return;
+
+    std::vector<Score> scores;
+    for (const RootMove& root_move : worker.root_moves) {
+        worker.board.make_move_unchecked(root_move.move);
+        const auto score = probe_tablebase(worker.board, 1);
+        worker.board.undo_move_unchecked();
+        if (!score) return;
+        scores.push_back((Score)-*score);
+    }
 
-        if (moves.empty()) {
-            break;  // No legal moves
-        }
+    const Score best = *std::ranges::max_element(scores);
+    size_t kept = 0;
+    for (size_t i = 0; i < scores.size(); ++i)
+        if (scores[i] == best) worker.root_moves[kept++] = worker.root_moves[i];
+    worker.root_moves.resize(kept);
+}
 
-        Score best_score = INT_MIN;
-        Move best_move = moves[0];
+Score Engine::Impl::search_root(SearchWorker& worker, const Depth depth, Score alpha, const Score beta,
+                                Move& best_move) {
+    Board& board = worker.board;
+    const Score original_alpha = alpha;
+    auto& root_moves = worker.root_moves;
+
+    // The move to beat goes first (after a fail high, the move that failed high)
+    if (config.use_move_ordering) {
+        const auto best = std::ranges::find(root_moves, best_move, &RootMove::move);
+        if (best != root_moves.end())
+            std::rotate(root_moves.begin(), best, best + 1);
+    }
 
-        for (const auto& move : moves) {
-            board.make_move(move);
-            const Score score = -negamax(board, depth - 1, -beta, -alpha);
-            board.undo_move();
+    worker.pv.clear(0);
+    Score best_score = -CHECKMATE - 1;
+    Move iteration_best = root_moves[0].move;
+
+    Position snapshot;
+    for (size_t i = 0; i < root_moves.size(); ++i) {
+        RootMove& root_move = root_moves[i];
+        const Move move = root_move.move;
+        const uint64_t nodes_before = worker.stats.nodes.load(std::memory_order_relaxed);
+        make_move(worker, move, snapshot);
+
+        // PVS at the root too: later moves only need to prove they don't beat the best
+        Score score;
+        if (i == 0 || !config.use_pvs) {
+            score = -negamax(worker, (Depth)(depth - 1), -beta, -alpha, 1);
+        } else {
+            score = -negamax(worker, (Depth)(depth - 1), -alpha - 1, -alpha, 1);
+            if (score > alpha && score < beta)
+                score = -negamax(worker, (Depth)(depth - 1), -beta, -alpha, 1);
+        }
+        unmake_move(worker, snapshot);
+        root_move.nodes += worker.stats.nodes.load(std::memory_order_relaxed) - nodes_before;
 
-            if (score > best_score) {
-                best_score = score;
-                best_move = move;
-                alpha = best_score;
+        if (stopped()) return best_score;
+
+        root_move.score = score;
+        if (score > best_score) {
+            best_score = score;
+            // On a fail low nothing is known to beat the move ordered first
+            if (score > alpha || i == 0) {
+                iteration_best = move;
+                worker.pv.update(0, move);
             }
+            alpha = std::max(alpha, score);
         }
 
-        // Update result
-        best_result.best_move = best_move;
-        best_result.score = best_score;
-        best_result.depth = depth;
-        best_result.nodes_searched = stats.nodes;
-        best_result.search_time = stats.elapsed_seconds();
+        if (alpha >= beta)
+            break;
+    }
 
-        // Report iteration
-        std::cout << "Depth " << depth << ": "
-                 << square_to_string(best_move.from()) << "-" << square_to_string(best_move.to())
-                 << " (score: " << best_score << ", nodes: " << stats.nodes
-                 << ", time: " << best_result.search_time << "s)" << std::endl;
+    best_move = iteration_best;
 
-        if (config.on_iteration_complete)
-            config.on_iteration_complete(best_result);
+    const Flag flag = best_score >= beta ? LOWER_BOUND
+                    : best_score > original_alpha ? EXACT
+                    : UPPER_BOUND;
+    if (config.use_transposition_table)
+        ttable->store(board.zobrist_hash(), best_score, depth, flag, best_move);
 
-        // Check time limit
-        if (stats.elapsed_seconds() * 1000 > time_limit.count())
-            break;
+    return best_score;
+}
+
+Score Engine::Impl::search_aspiration(SearchWorker& worker, const Depth depth, const Score previous,
+                                      Move& best_move) {
+    // Order by the previous iteration's subtree sizes: a move that needed many nodes
+    // to refute is likely the strongest alternative. Then count afresh for this depth.
+    auto& root_moves = worker.root_moves;
+    if (config.use_move_ordering)
+        std::ranges::stable_sort(root_moves, std::greater{}, &RootMove::nodes);
+    for (RootMove& root_move : root_moves)
+        root_move.nodes = 0;
+
+    // Shallow scores swing too much for a narrow window to pay off
+    if (!config.use_aspiration_windows || depth < 5 || is_mate(previous))
+        return search_root(worker, depth, -INFINITE_SCORE, INFINITE_SCORE, best_move);
+
+    Score delta = ASPIRATION_WINDOW;
+    Score alpha = std::max(previous - delta, -INFINITE_SCORE);
+    Score beta = std::min(previous + delta, INFINITE_SCORE);
+
+    while (true) {
+        const Score score = search_root(worker, depth, alpha, beta, best_move);
+        if (stopped()) return score;
+
+        // Widen only the side that failed, going to a full window after a few tries
+        delta *= 2;
+        if (score <= alpha)
+            alpha = delta > 1000 ? -INFINITE_SCORE : std::max(score - delta, -INFINITE_SCORE);
+        else if (score >= beta)
+            beta = delta > 1000 ? INFINITE_SCORE : std::min(score + delta, INFINITE_SCORE);
+        else
+            return score;
     }
+}
 
-    return best_result;
+// ============================================================================
+// Lazy SMP - Helper Threads Searching the Same Root
+// ============================================================================
+
+void Engine::Impl::helper_search(SearchWorker& worker, const int max_depth) {
+    Move best_move;
+    init_root_moves(worker);
+
+    // Odd helpers run one ply ahead of the main thread so the threads spread over
+    // neighbouring depths and fill the shared table with entries the others reuse
+    Score score = 0;
+    for (int depth = 1 + (worker.id & 1); depth <= max_depth && !stopped(); ++depth) {
+        worker.history.clear();
+        worker.killers.clear();
+        score = search_aspiration(worker, (Depth)depth, score, best_move);
+    }
 }
 
 // ============================================================================
-// Fixed Depth Search
+// Iterative Deepening - Progressive Deepening with Time Management
 // ============================================================================
 
-SearchResult Engine::Impl::search_fixed_depth(Board& board, const Depth max_depth) {
-    stats.start_time = std::chrono::high_resolution_clock::now();
-    stop_requested = false;
+SearchResult Engine::Impl::run_search(const Board& board, const int max_depth) {
+    stop_requested = config.stop_token.stop_requested();
+    ttable->new_search();
 
-    SearchResult result = {};
+    SearchResult best_result = {};
 
-    MoveList moves;
-    board.generate_moves(moves);
+    std::vector<std::unique_ptr<SearchWorker>> workers;
+    workers.push_back(std::make_unique<SearchWorker>(0, board, evaluator.network()));
+    SearchWorker& main = *workers[0];
+
+    last_pv.clear();
+    last_root = board.zobrist_hash();
 
-    if (moves.empty()) {
-        return result;  // No legal moves
+    init_root_moves(main);
+    if (main.root_moves.empty()) {
+        return best_result;  // No legal moves
     }
 
-    Score best_score = INT_MIN;
-    Move best_move = moves[0];
+    for (int id = 1; id < config.threads; ++id) {
+        workers.push_back(std::make_unique<SearchWorker>(id, board, evaluator.network()));
+    }
 
-    for (const auto& move : moves) {
-        board.make_move(move);
-        Score score = -negamax(board, max_depth - 1, (Score)-50000, (Score)50000);
-        board.undo_move();
+    std::vector<std::thread> helpers;
+    for (size_t id = 1; id < workers.size(); ++id) {
+        helpers.emplace_back(&Impl::helper_search, this, std::ref(*workers[id]), max_depth);
+    }
 
-        if (score > best_score) {
-            best_score = score;
-            best_move = move;
-        }
+    // Everyone's counters so far, and how much of the table this search has filled
+    const auto collect_stats = [this, &workers] {
+        SearchStats stats;
+        for (const auto& worker : workers)
+            worker->stats.add_to(stats);
+        if constexpr (COLLECT_STATS) stats.hashfull = ttable->hashfull();
+        return stats;
+    };
+
+    // Iterative deepening: search depth 1, 2, 3, ... until time runs out
+    Move best_move;
+    Score previous_score = 0;
+    for (int depth = 1; depth <= max_depth; ++depth) {
+        main.history.clear();
+        main.killers.clear();
+
+        const Score best_score = search_aspiration(main, (Depth)depth, previous_score, best_move);
+
+        // Interrupted iteration: keep the last completed one
+        if (stopped())
+            break;
+
+        // Update result
+        const uint64_t nodes_before = best_result.stats.nodes;
+        const double time_before = best_result.search_time;
+        best_result.best_move = best_move;
+        best_result.score = best_score;
+        best_result.depth = (Depth)depth;
+        best_result.stats = collect_stats();
+        best_result.nodes_searched = best_result.stats.nodes;
+        best_result.search_time = timer.elapsed_seconds();
+
+        IterationStats iteration {};
+        iteration.depth = (Depth)depth;
+        iteration.nodes = best_result.stats.nodes - nodes_before;
+        iteration.time = best_result.search_time - time_before;
+        iteration.nps = (double)iteration.nodes / std::max(iteration.time, 1e-9);
+        if (!best_result.iterations.empty() && best_result.iterations.back().nodes != 0)
+            iteration.branching_factor = (double)iteration.nodes / (double)best_result.iterations.back().nodes;
+        iteration.seldepth = best_result.stats.seldepth;
+        best_result.iterations.push_back(iteration);
+        best_result.pv.assign(main.pv.line[0].begin(), main.pv.line[0].begin() + main.pv.length[0]);
+        best_result.root_moves = main.root_moves;
+        std::ranges::stable_sort(best_result.root_moves, std::greater{}, &RootMove::score);
+        last_pv = best_result.pv;
+        previous_score = best_score;
+
+        // Report iteration (the caller decides how; nothing is printed from the search)
+        if (config.on_iteration_complete)
+            config.on_iteration_complete(best_result);
+
+        // Soft deadline: is the next iteration worth starting?
+        timer.iteration_complete(best_move);
+        if (!timer.should_continue())
+            break;
     }
 
-    result.best_move = best_move;
-    result.score = best_score;
-    result.depth = max_depth;
-    result.nodes_searched = stats.nodes;
-    result.search_time = stats.elapsed_seconds();
+    stop_requested = true;
+    for (auto& helper : helpers)
+        helper.join();
+
+    // Stopped before depth 1 completed: any legal move beats none
+    if (best_result.best_move == Move())
+        best_result.best_move = best_move != Move() ? best_move : main.root_moves[0].move;
+
+    best_result.stats = collect_stats();
+    best_result.nodes_searched = best_result.stats.nodes;
+    best_result.search_time = timer.elapsed_seconds();
+
+    return best_result;
+}
 
+std::optional<SearchResult> Engine::Impl::probe_book(const Board& board) {
+    if (!config.book) return std::nullopt;
+
+    const std::optional<Move> move = config.book->probe(board, config.book_selection, book_rng);
+    if (!move) return std::nullopt;
+
+    last_pv = { *move };
+    last_root = board.zobrist_hash();
+
+    SearchResult result = {};
+    result.best_move = *move;
+    result.pv = last_pv;
     return result;
 }
 
+SearchResult Engine::Impl::search_iterative(Board& board, const std::chrono::milliseconds time_limit) {
+    if (auto book_move = probe_book(board)) return *book_move;
+
+    timer.start(time_limit);
+    return run_search(board, config.max_depth);
+}
+
+SearchResult Engine::Impl::search_clock(Board& board, const TimeControl& time_control) {
+    if (auto book_move = probe_book(board)) return *book_move;
+
+    timer.start(time_control, config.use_move_stability);
+    return run_search(board, config.max_depth);
+}
+
+// ============================================================================
+// Fixed Depth Search
+// ============================================================================
+
+SearchResult Engine::Impl::search_fixed_depth(Board& board, const Depth max_depth) {
+    timer.start_infinite();
+    return run_search(board, max_depth);
+}
+
 Score Engine::Impl::evaluate(const Board& board) {
     // Negate score for negamax
     return evaluator.evaluate(board);
@@ -423,6 +1055,9 @@ Engine::Engine() : impl(std::make_unique<Impl>()) {}
 
 Engine::Engine(const SearchConfig& config) : impl(std::make_unique<Impl>(config)) {}
 
+Engine::Engine(const SearchConfig& config, std::shared_ptr<TranspositionTable> table)
+    : impl(std::make_unique<Impl>(config, std::move(table))) {}
+
 Engine::~Engine() = default;
 
 void Engine::set_config(const SearchConfig& config) const {
@@ -435,11 +1070,20 @@ SearchConfig Engine::get_config() const {
 
 void Engine::set_tt_size(const int mb) const {
     impl->config.tt_size_mb = mb;
-    impl->ttable.resize(mb);
+    impl->ttable->resize(mb);
 }
 
 void Engine::clear_cache() const {
-    impl->ttable.clear();
+    impl->ttable->clear();
+}
+
+void Engine::set_table(std::shared_ptr<TranspositionTable> table) const {
+    impl->table = std::move(table);
+    impl->ttable = impl->table.get();
+}
+
+void Engine::set_network(std::shared_ptr<const NnueNetwork> network) const {
+    impl->evaluator.set_network(std::move(network));
 }
 
 Score Engine::evaluate(const Board& board) const{
@@ -450,6 +1094,10 @@ void Engine::stop_search() const{
     impl->stop_requested = true;
 }
 
+void Engine::ponder_hit() const {
+    impl->timer.ponder_hit();
+}
+
 SearchResult Engine::find_best_move(Board board, const std::chrono::milliseconds time_limit) const {
     return impl->search_iterative(board, time_limit);
 }
@@ -458,25 +1106,33 @@ SearchResult Engine::find_best_move(Board board, const Depth max_depth) const {
     return impl->search_fixed_depth(board, max_depth);
 }
 
+SearchResult Engine::find_best_move(Board board, const TimeControl& time_control) const {
+    return impl->search_clock(board, time_control);
+}
+
 SearchResult Engine::find_best_move(Board board, const int max_depth, const std::chrono::milliseconds time_limit) const {
     impl->config.max_depth = max_depth;
     return impl->search_iterative(board, time_limit);
 }
 
-std::vector<Move> Engine::get_principal_variation(Board board, const int depth) const {
-    // Extract PV from transposition table
-    std::vector<Move> pv;
+std::vector<Move> Engine::get_principal_variation(Board board, int depth) const {
+    depth = std::clamp(depth, 0, MAX_PLY);
 
-    for (int i = 0; i < depth; ++i) {
+    // The last search's own line, when this is the position it searched
+    if (board.zobrist_hash() == impl->last_root && !impl->last_pv.empty()) {
+        const auto& pv = impl->last_pv;
+        return {pv.begin(), pv.begin() + std::min<ptrdiff_t>(depth, std::ssize(pv))};
+    }
 
-        const auto entry = impl->ttable.lookup(board.zobrist_hash(), 0);
-        if (!entry)
+    // Otherwise walk the transposition table, vetting each move against the position
+    std::vector<Move> pv;
+    for (int i = 0; i < depth; ++i) {
+        const auto entry = impl->ttable->lookup(board.zobrist_hash(), 0);
+        if (!entry || !board.is_generated_move(entry->best_move))
             break;
 
-        Move best_move = entry->best_move;
-
-        pv.push_back(best_move);
-        board.make_move(best_move);
+        pv.push_back(entry->best_move);
+        board.make_move_unchecked(entry->best_move);
     }
 
     return pv;
@@ -486,7 +1142,8 @@ MoveList Engine::get_ranked_moves(const Board& board) const {
     MoveList moves;
     board.generate_moves(moves);
 
-    impl->order_moves(moves, board, Move());
+    const SearchWorker worker(0, board, nullptr);
+    impl->order_moves(worker, moves, Move());
 
     return moves;
 }
@@ -498,7 +1155,9 @@ Engine::Analysis Engine::analyze(const Board& board, const int depth) const {
     analysis.best_move = result.best_move;
     analysis.score = result.score;
     analysis.depth = result.depth;
-    analysis.pv = get_principal_variation(board, depth);
+    analysis.pv = result.pv;
+    for (const RootMove& root_move : result.root_moves)
+        analysis.move_scores.emplace_back(root_move.move, root_move.score);
 
     return analysis;
 }
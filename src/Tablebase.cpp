@@ -0,0 +1,297 @@
+#include "chess/Tablebase.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include "chess/internal/Bitboard.hpp"
+
+namespace chess
+{
+    using namespace internal;
+
+    namespace
+    {
+        constexpr uint8_t DRAW_VALUE = 0;
+        constexpr uint8_t INVALID = 0xFF;   // Generation only: not a legal position
+
+        constexpr PieceType TABLE_TYPES[] = { PieceType::QUEEN, PieceType::ROOK, PieceType::PAWN };
+
+        struct Header {
+            uint32_t magic;
+            uint32_t piece_type;
+            uint32_t entries;
+            uint32_t reserved;
+        };
+
+        constexpr size_t index(const int stm, const int wk, const int bk, const int piece) {
+            return (((size_t)stm * 64 + wk) * 64 + bk) * 64 + piece;
+        }
+
+        constexpr Bitboard bit(const int sq) { return 1ULL << sq; }
+
+        /// Squares the white piece attacks with the given occupancy
+        Bitboard attacks(const PieceType type, const int sq, const Bitboard occupancy) {
+            switch (type) {
+            case PieceType::PAWN:   return PAWN_ATTACKS[(int)Color::WHITE][sq];
+            case PieceType::KNIGHT: return KNIGHT_ATTACKS[sq];
+            case PieceType::BISHOP: return bishop_attacks((Square)sq, occupancy);
+            case PieceType::ROOK:   return rook_attacks((Square)sq, occupancy);
+            default:                return queen_attacks((Square)sq, occupancy);
+            }
+        }
+
+        // ============================================================================
+        // Retrograde generation
+        // ============================================================================
+
+        /// Solves one KXvK table, X on white's side. Passes resolve positions in
+        /// order of distance to mate: in pass p a position is mate in p plies if a
+        /// move reaches a loss already known to be p - 1 plies deep, or lost in p
+        /// if every move reaches a win no deeper than p - 1. Whatever remains
+        /// unresolved when the passes stop is a draw.
+        class Generator {
+        public:
+            Generator(const PieceType type, const std::array<std::vector<uint8_t>, 6>& solved)
+                : type(type), solved(solved), values(Tablebase::TABLE_ENTRIES, INVALID) {}
+
+            std::vector<uint8_t> solve() {
+                std::vector<uint32_t> pending;
+                for (int stm = 0; stm < 2; ++stm)
+                    for (int wk = 0; wk < 64; ++wk)
+                        for (int bk = 0; bk < 64; ++bk)
+                            for (int x = 0; x < 64; ++x)
+                                if (legal(stm, wk, bk, x)) {
+                                    values[index(stm, wk, bk, x)] = DRAW_VALUE;
+                                    pending.push_back((uint32_t)index(stm, wk, bk, x));
+                                }
+
+                // Promotions reach finished tables at any depth, so keep going
+                // at least until the deepest of those mates has had its turn
+                int deepest_external = 0;
+                for (const auto& table : solved)
+                    for (const uint8_t v : table)
+                        if (v != INVALID && v != DRAW_VALUE) deepest_external = std::max(deepest_external, v - 1);
+
+                for (int pass = 0; !pending.empty(); ++pass) {
+                    std::vector<std::pair<uint32_t, uint8_t>> resolved;
+                    std::erase_if(pending, [&](const uint32_t i) {
+                        const int dtm = evaluate(i, pass);
+                        if (dtm < 0) return false;
+                        resolved.emplace_back(i, (uint8_t)(dtm + 1));
+                        return true;
+                    });
+
+                    // Written after the pass, so it only ever sees shallower results
+                    for (const auto& [i, v] : resolved)
+                        values[i] = v;
+                    if (resolved.empty() && pass > deepest_external + 1)
+                        break;
+                }
+
+                std::ranges::replace(values, INVALID, DRAW_VALUE);
+                return std::move(values);
+            }
+
+        private:
+            PieceType type;
+            const std::array<std::vector<uint8_t>, 6>& solved;
+            std::vector<uint8_t> values;
+
+            [[nodiscard]] bool legal(const int stm, const int wk, const int bk, const int x) const {
+                if (wk == bk || x == wk || x == bk || (KING_ATTACKS[wk] & bit(bk)))
+                    return false;
+                if (type == PieceType::PAWN && (x < 8 || x >= 56))
+                    return false;
+                // White to move with black in check: black's last move was illegal
+                return stm == (int)Color::BLACK || !(attacks(type, x, bit(wk) | bit(bk)) & bit(bk));
+            }
+
+            /// Distance to mate of a successor (side to move there), or -1 unless
+            /// it was resolved before this pass
+            [[nodiscard]] static int known(const uint8_t v, const int pass) {
+                if (v == DRAW_VALUE) return -1;
+                const int dtm = v - 1;
+                return dtm < pass ? dtm : -1;
+            }
+
+            /// Distance to mate if position i resolves in this pass, else -1
+            [[nodiscard]] int evaluate(const uint32_t i, const int pass) const {
+                const int x = (int)(i % 64);
+                const int bk = (int)(i / 64 % 64);
+                const int wk = (int)(i / 4096 % 64);
+                const int stm = (int)(i / 262144);
+
+                int best_win = -1;      // Shallowest loss we can move into
+                int worst_loss = -1;    // Deepest win the opponent gets
+                bool unknown = false;
+                bool draw = false;
+                int moves = 0;
+
+                const auto consider = [&](const uint8_t v, const bool final_draw) {
+                    ++moves;
+                    if (final_draw) { draw = true; return; }
+                    const int dtm = known(v, pass);
+                    if (dtm < 0) { unknown = true; return; }
+                    if (dtm % 2 == 0) best_win = best_win < 0 ? dtm : std::min(best_win, dtm);
+                    else worst_loss = std::max(worst_loss, dtm);
+                };
+
+                if (stm == (int)Color::WHITE) {
+                    // King: never next to the black king, never onto the piece
+                    for (const Square to : Squares(KING_ATTACKS[wk] & ~KING_ATTACKS[bk] & ~bit(x)))
+                        consider(values[index(1, (int)to, bk, x)], false);
+
+                    if (type == PieceType::PAWN) {
+                        const int push = x + 8;
+                        if (push != wk && push != bk) {
+                            if (push >= 56) {
+                                // Queen and rook promotions land in finished tables; minor pieces draw
+                                const uint8_t queen = solved[(int)PieceType::QUEEN][index(1, wk, bk, push)];
+                                const uint8_t rook = solved[(int)PieceType::ROOK][index(1, wk, bk, push)];
+                                consider(queen, queen == DRAW_VALUE);
+                                consider(rook, rook == DRAW_VALUE);
+                                consider(DRAW_VALUE, true);
+                                consider(DRAW_VALUE, true);
+                            } else {
+                                consider(values[index(1, wk, bk, push)], false);
+                                if (x < 16 && push + 8 != wk && push + 8 != bk)
+                                    consider(values[index(1, wk, bk, push + 8)], false);
+                            }
+                        }
+                    } else {
+                        for (const Square to : Squares(attacks(type, x, bit(wk) | bit(bk)) & ~bit(wk) & ~bit(bk)))
+                            consider(values[index(1, wk, bk, (int)to)], false);
+                    }
+                } else {
+                    for (const Square to : Squares(KING_ATTACKS[bk] & ~KING_ATTACKS[wk])) {
+                        // Taking the undefended piece leaves bare kings
+                        if ((int)to == x) {
+                            consider(DRAW_VALUE, true);
+                            continue;
+                        }
+                        if (attacks(type, x, bit(wk) | bit((int)to)) & bit((int)to))
+                            continue;
+                        consider(values[index(0, wk, (int)to, x)], false);
+                    }
+                }
+
+                if (moves == 0) {
+                    // Checkmate is a loss in 0; stalemate stays a draw
+                    const bool in_check = stm == (int)Color::BLACK &&
+                                          (attacks(type, x, bit(wk) | bit(bk)) & bit(bk));
+                    return in_check && pass == 0 ? 0 : -1;
+                }
+                // Both come out at exactly `pass`: anything shallower resolved earlier
+                if (best_win >= 0) return best_win + 1;
+                if (!unknown && !draw) return worst_loss + 1;
+                return -1;
+            }
+        };
+    }
+
+    // ============================================================================
+    // Files
+    // ============================================================================
+
+    std::string Tablebase::file_name(const PieceType type)
+    {
+        constexpr char LETTERS[] = "PNBRQK";
+        return std::string("K") + LETTERS[(int)type] + "vK.ctb";
+    }
+
+    void Tablebase::generate(const std::string& directory)
+    {
+        init_attacks();
+        std::filesystem::create_directories(directory);
+
+        // Pawn endings promote into the queen and rook tables, so those come first
+        std::array<std::vector<uint8_t>, 6> solved;
+        for (const PieceType type : TABLE_TYPES) {
+            solved[(int)type] = Generator(type, solved).solve();
+
+            const Header header = { MAGIC, (uint32_t)type, (uint32_t)TABLE_ENTRIES, 0 };
+            const std::string path = (std::filesystem::path(directory) / file_name(type)).string();
+            std::ofstream out(path, std::ios::binary);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(solved[(int)type].data()), (std::streamsize)TABLE_ENTRIES);
+            if (!out)
+                throw std::runtime_error("Cannot write " + path);
+        }
+    }
+
+    std::shared_ptr<const Tablebase> Tablebase::open(const std::string& directory)
+    {
+        std::shared_ptr<Tablebase> tb(new Tablebase());
+
+        for (const PieceType type : TABLE_TYPES) {
+            const std::filesystem::path path = std::filesystem::path(directory) / file_name(type);
+            if (!std::filesystem::exists(path))
+                continue;
+
+            MappedFile file(path.string());
+            Header header {};
+            if (file.size() == HEADER_BYTES + TABLE_ENTRIES)
+                std::memcpy(&header, file.data(), sizeof(header));
+            if (header.magic != MAGIC || header.piece_type != (uint32_t)type || header.entries != TABLE_ENTRIES)
+                throw std::runtime_error("Not a tablebase file: " + path.string());
+
+            tb->tables[(int)type] = reinterpret_cast<const uint8_t*>(file.data() + HEADER_BYTES);
+            tb->files[(int)type] = std::move(file);
+            tb->max_pieces = 3;
+        }
+        return tb;
+    }
+
+    // ============================================================================
+    // Probing
+    // ============================================================================
+
+    std::optional<TablebaseResult> Tablebase::probe(const Position& pos) const
+    {
+        const int pieces = popcount(pos.occupancy_all);
+        if (pieces > 3 || pos.castle_rights != 0)
+            return std::nullopt;
+        if (pieces == 2)
+            return TablebaseResult{ Wdl::DRAW, 0 };
+
+        // The one piece besides the kings
+        Color strong = Color::WHITE;
+        PieceType type = PieceType::NONE;
+        for (int color = 0; color < 2 && type == PieceType::NONE; ++color)
+            for (int t = 0; t < (int)PieceType::KING; ++t)
+                if (pos.pieces[color][t]) {
+                    strong = (Color)color;
+                    type = (PieceType)t;
+                    break;
+                }
+
+        if (type == PieceType::KNIGHT || type == PieceType::BISHOP)
+            return TablebaseResult{ Wdl::DRAW, 0 };
+        if (!tables[(int)type])
+            return std::nullopt;
+
+        // Tables hold the piece on white's side; otherwise probe the mirror image
+        int wk = lsb(pos.pieces[(int)Color::WHITE][(int)PieceType::KING]);
+        int bk = lsb(pos.pieces[(int)Color::BLACK][(int)PieceType::KING]);
+        int x = lsb(pos.pieces[(int)strong][(int)type]);
+        int stm = (int)pos.side_to_move;
+        if (strong == Color::BLACK) {
+            std::swap(wk, bk);
+            wk ^= 56;
+            bk ^= 56;
+            x ^= 56;
+            stm ^= 1;
+        }
+
+        const uint8_t v = tables[(int)type][index(stm, wk, bk, x)];
+        if (v == DRAW_VALUE)
+            return TablebaseResult{ Wdl::DRAW, 0 };
+        const int dtm = v - 1;
+        return TablebaseResult{ dtm % 2 == 1 ? Wdl::WIN : Wdl::LOSS, dtm };
+    }
+
+}  // namespace chess
@@ -0,0 +1,98 @@
+#include "chess/TimeManager.hpp"
+
+#include <algorithm>
+
+namespace chess {
+
+namespace {
+
+constexpr int DEFAULT_MOVES_TO_GO = 30;     // Moves we expect still to play in sudden death
+constexpr int MAX_MOVES_TO_GO = 50;
+constexpr double HARD_FACTOR = 4.0;         // Hard deadline as a multiple of the soft one
+constexpr double MAX_SOFT_SHARE = 0.6;      // Never plan on more than this share of the clock...
+constexpr double MAX_HARD_SHARE = 0.8;      // ...nor spend more than this share of it
+constexpr double MIN_BRANCHING = 1.5;
+constexpr double MAX_BRANCHING = 6.0;
+
+}  // namespace
+
+void TimeManager::start(const TimeControl& tc, const bool stability_control) {
+    using std::chrono::milliseconds;
+
+    if (tc.move_time > milliseconds(0)) {
+        start(std::max(tc.move_time - tc.overhead, milliseconds(1)));
+        pondering = tc.ponder;
+        return;
+    }
+
+    start_infinite();
+    timed = true;
+    use_stability = stability_control;
+    pondering = tc.ponder;
+
+    const milliseconds available = std::max(tc.remaining - tc.overhead, milliseconds(1));
+    const int moves_to_go = tc.moves_to_go > 0 ? std::min(tc.moves_to_go, MAX_MOVES_TO_GO) : DEFAULT_MOVES_TO_GO;
+
+    // An even share of what's left, plus most of the increment we are about to get back
+    const milliseconds base = available / moves_to_go + tc.increment * 3 / 4;
+
+    soft = std::clamp(base, milliseconds(1), milliseconds((int64_t)((double)available.count() * MAX_SOFT_SHARE)));
+    hard = std::clamp(milliseconds((int64_t)((double)soft.count() * HARD_FACTOR)), soft,
+                      std::max(soft, milliseconds((int64_t)((double)available.count() * MAX_HARD_SHARE))));
+    hard_deadline = start_time + hard;
+}
+
+void TimeManager::start(const std::chrono::milliseconds limit) {
+    start_infinite();
+    timed = true;
+    soft = hard = limit;
+    hard_deadline = start_time + hard;
+}
+
+void TimeManager::start_infinite() {
+    start_time = iteration_start = hard_deadline = clock::now();
+    soft = hard = std::chrono::milliseconds(0);
+    timed = use_stability = best_changed = false;
+    pondering = false;
+    last_iteration = previous_iteration = clock::duration(0);
+    last_best = Move();
+    stability = 0;
+}
+
+void TimeManager::iteration_complete(const Move best_move) {
+    const auto now = clock::now();
+    previous_iteration = last_iteration;
+    last_iteration = now - iteration_start;
+    iteration_start = now;
+
+    best_changed = best_move != last_best;
+    stability = best_changed ? 0 : stability + 1;
+    last_best = best_move;
+}
+
+bool TimeManager::should_continue() const {
+    if (!timed || pondering.load(std::memory_order_relaxed)) return true;
+
+    const auto spent = clock::now() - start_time;
+
+    // Unstable best move: keep thinking; settled one: move early
+    double scale = 1.0;
+    if (use_stability)
+        scale = best_changed ? 1.5 : std::max(0.5, 1.0 - 0.1 * stability);
+
+    if (spent >= std::chrono::duration_cast<clock::duration>(soft * scale))
+        return false;
+
+    // The next iteration costs about branching factor times the last one
+    if (previous_iteration.count() > 0 && last_iteration.count() > 0) {
+        const double branching = std::clamp((double)last_iteration.count() / (double)previous_iteration.count(),
+                                            MIN_BRANCHING, MAX_BRANCHING);
+        const auto predicted = std::chrono::duration_cast<clock::duration>(last_iteration * branching);
+        if (start_time + spent + predicted > hard_deadline)
+            return false;
+    }
+
+    return true;
+}
+
+}  // namespace chess
@@ -1,4 +1,5 @@
 #include <cmath>
+#include <cstring>
 
 #include "../../include/chess/internal/Bitboard.hpp"
 
@@ -81,10 +82,130 @@ namespace chess::internal {
         }
     }
 
+    // Magic multipliers, found offline by random search (sparse candidates,
+    // verified to map every relevant occupancy without destructive collisions)
+    constexpr Bitboard ROOK_MAGIC_NUMBERS[64] = {
+        0x0280132180004001ULL, 0x0140001000200040ULL, 0x0880200010000880ULL, 0x2080080005801000ULL,
+        0x0200041020080200ULL, 0x0200041041084200ULL, 0x0400080081124410ULL, 0x2180042100004080ULL,
+        0x8000800099644000ULL, 0x0802003040820100ULL, 0x0105801001862000ULL, 0x0101002008100100ULL,
+        0x1000800400080080ULL, 0x0804800200040080ULL, 0x2001800200800900ULL, 0x00160004088204C1ULL,
+        0x228000C001402000ULL, 0x8510004000200050ULL, 0x3001848020029000ULL, 0x0280808010000801ULL,
+        0x0109010010040800ULL, 0x8000808004000200ULL, 0x8000040081021028ULL, 0x40040A0009004884ULL,
+        0x80C0004280008035ULL, 0x0010004040002000ULL, 0x1101200500410070ULL, 0x8410100080080080ULL,
+        0x000C080080800400ULL, 0x4012008080040002ULL, 0x4000040101000200ULL, 0x0061010200008044ULL,
+        0x0080804010800020ULL, 0x3000201008400040ULL, 0x4112008012002444ULL, 0x0848000880801000ULL,
+        0x00A8008008800400ULL, 0x200200280A00500CULL, 0x080A221024004801ULL, 0xC400008042000104ULL,
+        0x8000400080028022ULL, 0x0220008040018020ULL, 0x4000200011010040ULL, 0x10060040210A0010ULL,
+        0x40820020904A0004ULL, 0x0030040002008080ULL, 0x0200020801840010ULL, 0x0084C04100820004ULL,
+        0x4802010080C2A600ULL, 0x0000400080201880ULL, 0x2040801000200080ULL, 0x0180200842001200ULL,
+        0x0013510008000500ULL, 0x0182000C00808A80ULL, 0x1000524821302400ULL, 0x3800040108488200ULL,
+        0x104A004810210082ULL, 0x0004210010420082ULL, 0xC424110008200241ULL, 0x90101000A0088501ULL,
+        0x0182000420100802ULL, 0x4822001001080402ULL, 0x05D0080090012204ULL, 0x2008140089042846ULL
+    };
+
+    constexpr Bitboard BISHOP_MAGIC_NUMBERS[64] = {
+        0x0420220228022C80ULL, 0x200208010C108000ULL, 0x1004010411040040ULL, 0x12A4040292002440ULL,
+        0x0804042082000850ULL, 0x0802020220010440ULL, 0x800401048260201AULL, 0x0041010800828800ULL,
+        0x4040641488080104ULL, 0x20002004016E0020ULL, 0x0C2C223A12420042ULL, 0x0100024081020220ULL,
+        0x0383211041025080ULL, 0x08C0030420160600ULL, 0x0C1000510808C00AULL, 0x40501A0084140280ULL,
+        0x40280040112C0088ULL, 0x4020040908110050ULL, 0x1028001008801412ULL, 0x0104220202020000ULL,
+        0x800A000400940010ULL, 0x0401000200512410ULL, 0x1082012100900408ULL, 0x0101402208440C00ULL,
+        0x00482104C01C1111ULL, 0x0310105008017101ULL, 0x0022010108080020ULL, 0x02300400104010A0ULL,
+        0x1401010011444000ULL, 0x1001020000405020ULL, 0x00010A0804480411ULL, 0x0419220010404400ULL,
+        0x0010020A00200820ULL, 0xA008280909040104ULL, 0x0210209010080020ULL, 0x3006110800040040ULL,
+        0x0800820200440090ULL, 0x0008100421810080ULL, 0x0028060093264800ULL, 0x0A08004088810080ULL,
+        0x3611100290442000ULL, 0x0241081282001001ULL, 0x11081108010D0800ULL, 0x002A102014420800ULL,
+        0x480002600A004500ULL, 0x8001010102000100ULL, 0x2008080810410883ULL, 0x0002080901101022ULL,
+        0x2800942420444080ULL, 0x2000840108024000ULL, 0x0000804844100040ULL, 0x1444120020884540ULL,
+        0x0004001002020C00ULL, 0x041041C801010049ULL, 0x0060045000850810ULL, 0x1003240C14820208ULL,
+        0x3010104A10100800ULL, 0x0280020101580200ULL, 0x1000000101081600ULL, 0x0644009800420200ULL,
+        0x0050040008102402ULL, 0x00000004601C8106ULL, 0x00088530040812A0ULL, 0x800218010102020CULL
+    };
+
+    /// Walk the rays from sq until blocked. Only used to fill the magic tables.
+    Bitboard sliding_attacks(const int sq, const Bitboard occupancy, const int (&directions)[4][2]) {
+        Bitboard attacks = 0;
+        const int file = sq & 7;
+        const int rank = sq >> 3;
+
+        for (const auto& [df, dr] : directions) {
+            for (int f = file + df, r = rank + dr; f >= 0 && f < 8 && r >= 0 && r < 8; f += df, r += dr) {
+                const int t = f + (r << 3);
+                attacks |= 1ULL << t;
+                if (occupancy & (1ULL << t)) break;
+            }
+        }
+
+        return attacks;
+    }
+
+    void init_slider_attacks(Magic (&magics)[64], Bitboard* table, const Bitboard (&magic_numbers)[64],
+                             const int (&directions)[4][2]) {
+        Bitboard* next = table;
+
+        for (int sq = 0; sq < 64; ++sq) {
+            // Board edges are irrelevant unless the slider stands on them
+            const int file = sq & 7;
+            const int rank = sq >> 3;
+            const Bitboard edges = ((0x00000000000000FFULL | 0xFF00000000000000ULL) & ~(0xFFULL << (rank * 8))) |
+                                   ((0x0101010101010101ULL | 0x8080808080808080ULL) & ~(0x0101010101010101ULL << file));
+
+            Magic& m = magics[sq];
+            m.mask = sliding_attacks(sq, 0, directions) & ~edges;
+            m.magic = magic_numbers[sq];
+            m.shift = 64 - popcount(m.mask);
+            m.attacks = next;
+
+            // Carry-Rippler: enumerate every subset of the mask
+            Bitboard subset = 0;
+            do {
+                m.attacks[m.index(subset)] = sliding_attacks(sq, subset, directions);
+                subset = (subset - m.mask) & m.mask;
+            } while (subset);
+
+            next += 1ULL << popcount(m.mask);
+        }
+    }
+
+    void init_sliding_attacks() {
+        constexpr int rook_directions[4][2] = {{0, 1}, {0, -1}, {1, 0}, {-1, 0}};
+        constexpr int bishop_directions[4][2] = {{1, 1}, {-1, 1}, {1, -1}, {-1, -1}};
+
+        init_slider_attacks(ROOK_MAGICS, ROOK_TABLE, ROOK_MAGIC_NUMBERS, rook_directions);
+        init_slider_attacks(BISHOP_MAGICS, BISHOP_TABLE, BISHOP_MAGIC_NUMBERS, bishop_directions);
+    }
+
+    void init_line_tables() {
+        for (int a = 0; a < 64; ++a) {
+            const Bitboard a_bb = 1ULL << a;
+            for (int b = 0; b < 64; ++b) {
+                const Bitboard b_bb = 1ULL << b;
+                BETWEEN[a][b] = 0;
+                LINE[a][b] = 0;
+
+                if (a == b) continue;
+
+                for (const auto slider : {rook_attacks, bishop_attacks}) {
+                    if (slider((Square)a, 0) & b_bb) {
+                        LINE[a][b] = (slider((Square)a, 0) & slider((Square)b, 0)) | a_bb | b_bb;
+                        BETWEEN[a][b] = slider((Square)a, b_bb) & slider((Square)b, a_bb);
+                    }
+                }
+            }
+        }
+    }
+
     void init_attacks() {
-        init_knight_attacks();
-        init_king_attacks();
-        init_pawn_attacks();
+        // Magic static: built exactly once per process, concurrent callers wait for it
+        static const bool built = [] {
+            init_knight_attacks();
+            init_king_attacks();
+            init_pawn_attacks();
+            init_sliding_attacks();
+            init_line_tables();
+            return true;
+        }();
+        (void)built;
     }
 
 }  // namespace chess::internal
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "../../include/chess/internal/LargePages.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace chess::internal {
+
+    LargePageBuffer::LargePageBuffer(const size_t size) {
+        // Whole huge pages, so the tail of the table gets a huge page too
+        bytes = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        if (bytes == 0) return;
+
+#if defined(__linux__)
+        ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (ptr == MAP_FAILED) {
+            // No reserved huge pages: take ordinary pages and ask for transparent ones
+            ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ptr == MAP_FAILED) {
+                ptr = nullptr;
+                throw std::bad_alloc();
+            }
+            madvise(ptr, bytes, MADV_HUGEPAGE);
+        }
+        mapped = true;
+#else
+        ptr = std::aligned_alloc(HUGE_PAGE_SIZE, bytes);
+        if (!ptr) throw std::bad_alloc();
+#endif
+    }
+
+    LargePageBuffer::~LargePageBuffer() {
+        release();
+    }
+
+    LargePageBuffer::LargePageBuffer(LargePageBuffer&& other) noexcept
+        : ptr(other.ptr), bytes(other.bytes), mapped(other.mapped) {
+        other.ptr = nullptr;
+        other.bytes = 0;
+    }
+
+    LargePageBuffer& LargePageBuffer::operator=(LargePageBuffer&& other) noexcept {
+        if (this != &other) {
+            release();
+            ptr = other.ptr;
+            bytes = other.bytes;
+            mapped = other.mapped;
+            other.ptr = nullptr;
+            other.bytes = 0;
+        }
+        return *this;
+    }
+
+    void LargePageBuffer::release() {
+        if (!ptr) return;
+
+#if defined(__linux__)
+        if (mapped) munmap(ptr, bytes);
+#else
+        std::free(ptr);
+#endif
+        ptr = nullptr;
+        bytes = 0;
+    }
+
+    void parallel_clear(void* ptr, const size_t bytes, unsigned threads) {
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+
+        // Not worth spawning threads for small tables
+        if (threads == 1 || bytes < 64 * LargePageBuffer::HUGE_PAGE_SIZE) {
+            std::memset(ptr, 0, bytes);
+            return;
+        }
+
+        // Slices are whole huge pages so no page is shared between two threads
+        const size_t pages = (bytes + LargePageBuffer::HUGE_PAGE_SIZE - 1) / LargePageBuffer::HUGE_PAGE_SIZE;
+        const size_t slice = (pages + threads - 1) / threads * LargePageBuffer::HUGE_PAGE_SIZE;
+
+        std::vector<std::thread> workers;
+        for (size_t offset = 0; offset < bytes; offset += slice) {
+            const size_t length = std::min(slice, bytes - offset);
+            workers.emplace_back([=] { std::memset(static_cast<char*>(ptr) + offset, 0, length); });
+        }
+
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+}  // namespace chess::internal
@@ -0,0 +1,85 @@
+#include "../../include/chess/internal/MappedFile.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CHESS_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace chess::internal {
+
+    MappedFile::MappedFile(const std::string& path) {
+#if defined(CHESS_HAVE_MMAP)
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("Cannot open " + path);
+
+        struct stat info {};
+        if (fstat(fd, &info) != 0) {
+            close(fd);
+            throw std::runtime_error("Cannot stat " + path);
+        }
+        bytes = (size_t)info.st_size;
+
+        // An empty file maps to nothing; callers reject it by size
+        if (bytes > 0) {
+            void* mapped = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+            if (mapped == MAP_FAILED) {
+                close(fd);
+                throw std::runtime_error("Cannot map " + path);
+            }
+            ptr = static_cast<const std::byte*>(mapped);
+        }
+        close(fd);  // The mapping keeps the file referenced
+#else
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in)
+            throw std::runtime_error("Cannot open " + path);
+
+        bytes = (size_t)in.tellg();
+        fallback = std::make_unique<std::byte[]>(bytes);
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(fallback.get()), (std::streamsize)bytes);
+        if (!in)
+            throw std::runtime_error("Cannot read " + path);
+        ptr = fallback.get();
+#endif
+    }
+
+    MappedFile::~MappedFile() {
+        release();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : ptr(other.ptr), bytes(other.bytes), fallback(std::move(other.fallback)) {
+        other.ptr = nullptr;
+        other.bytes = 0;
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            release();
+            ptr = other.ptr;
+            bytes = other.bytes;
+            fallback = std::move(other.fallback);
+            other.ptr = nullptr;
+            other.bytes = 0;
+        }
+        return *this;
+    }
+
+    void MappedFile::release() {
+#if defined(CHESS_HAVE_MMAP)
+        if (ptr) munmap(const_cast<std::byte*>(ptr), bytes);
+#endif
+        fallback.reset();
+        ptr = nullptr;
+        bytes = 0;
+    }
+
+}  // namespace chess::internal
@@ -1,9 +1,20 @@
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
 #include "chess/Board.hpp"
+#include "chess/EpdReader.hpp"
 #include "chess/Move.hpp"
+#include "chess/PackedPosition.hpp"
+#include "chess/Perft.hpp"
+#include "chess/PgnReader.hpp"
+#include "chess/ZobristHasher.hpp"
+#include "chess/internal/Bitboard.hpp"
 
 using namespace chess;
 
@@ -87,6 +98,27 @@ void test_fen() {
     test_assert(board.side_to_move() == Color::BLACK, "FEN: Black to move");
     test_assert(board.en_passant_square() == Square::E3, "FEN: En passant square E3");
     test_assert(board.piece_at(Square::E4) == Piece::WHITE_PAWN, "FEN: White pawn on E4");
+
+    // Boards that aren't 8 ranks of 8 files would put pieces off the board
+    const char* malformed[] = {
+        "rnbqkbnrr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",  // Nine files
+        "8/8/8/8/8/8/8/8/k7 w - - 0 1",                                // Nine ranks
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBN w KQkq - 0 1",    // Seven files
+        "rnbqkbnr/pppppppp/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",     // Seven ranks
+        "rnbqkbnr/pppppppp/8/8/44P/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", // Digits past the rank
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR/ w KQkq - 0 1",  // Trailing slash
+    };
+    bool all_threw = true;
+    for (const char* fen : malformed) {
+        bool threw = false;
+        try {
+            board.load_fen(fen);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        all_threw = all_threw && threw;
+    }
+    test_assert(all_threw, "FEN: boards without 8 ranks of 8 files are rejected");
 }
 
 // ============================================================================
@@ -155,22 +187,22 @@ void test_captures() {
     // Position with a capture available
     board.load_fen("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1");
     
-    // Black plays e5
-    Move e5(Square::E7, Square::E5, MoveFlag::NORMAL);
-    board.make_move(e5);
+    // Black plays d5
+    Move d5(Square::D7, Square::D5, MoveFlag::NORMAL);
+    board.make_move(d5);
     
-    // White captures: e4xe5
-    Move capture(Square::E4, Square::E5, MoveFlag::CAPTURE);
+    // White captures: e4xd5
+    Move capture(Square::E4, Square::D5, MoveFlag::CAPTURE);
     board.make_move(capture);
     
-    test_assert(board.piece_at(Square::E5) == Piece::WHITE_PAWN, "White pawn on E5 after capture");
+    test_assert(board.piece_at(Square::D5) == Piece::WHITE_PAWN, "White pawn on D5 after capture");
     test_assert(board.piece_at(Square::E4) == Piece::NONE, "E4 empty after capture");
     test_assert(board.halfmove_clock() == 0, "Halfmove clock reset on capture");
     
     // Undo capture
     board.undo_move();
     test_assert(board.piece_at(Square::E4) == Piece::WHITE_PAWN, "Pawn back on E4");
-    test_assert(board.piece_at(Square::E5) == Piece::BLACK_PAWN, "Black pawn restored");
+    test_assert(board.piece_at(Square::D5) == Piece::BLACK_PAWN, "Black pawn restored");
 }
 
 // ============================================================================
@@ -510,6 +542,540 @@ void test_display() {
     test_assert(display.find("r n b q k b n r") != std::string::npos, "Display shows pieces");
 }
 
+// ============================================================================
+// Test: Sliding Attacks
+// ============================================================================
+
+Bitboard reference_ray_attacks(const int sq, const Bitboard occupancy, const int (&directions)[4][2]) {
+    Bitboard attacks = 0;
+    for (const auto& [df, dr] : directions) {
+        for (int f = sq % 8 + df, r = sq / 8 + dr; f >= 0 && f < 8 && r >= 0 && r < 8; f += df, r += dr) {
+            attacks |= 1ULL << (f + r * 8);
+            if (occupancy & (1ULL << (f + r * 8))) break;
+        }
+    }
+    return attacks;
+}
+
+void test_sliding_attacks() {
+    std::cout << "\n=== Testing Sliding Attacks ===" << std::endl;
+
+    Board board;  // Constructing a board initializes the attack tables
+
+    constexpr int rook_dirs[4][2] = {{0, 1}, {0, -1}, {1, 0}, {-1, 0}};
+    constexpr int bishop_dirs[4][2] = {{1, 1}, {-1, 1}, {1, -1}, {-1, -1}};
+
+    // Deterministic pseudo-random occupancies (xorshift)
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    bool rook_ok = true, bishop_ok = true;
+    for (int i = 0; i < 2000; ++i) {
+        state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+        const Bitboard occupancy = state & (state >> 3);
+
+        for (int sq = 0; sq < 64; ++sq) {
+            rook_ok &= internal::rook_attacks((Square)sq, occupancy) == reference_ray_attacks(sq, occupancy, rook_dirs);
+            bishop_ok &= internal::bishop_attacks((Square)sq, occupancy) == reference_ray_attacks(sq, occupancy, bishop_dirs);
+        }
+    }
+
+    test_assert(rook_ok, "Rook table lookups match ray walk");
+    test_assert(bishop_ok, "Bishop table lookups match ray walk");
+    test_assert(internal::queen_attacks(Square::D4, 0) == (reference_ray_attacks(27, 0, rook_dirs) |
+                                                           reference_ray_attacks(27, 0, bishop_dirs)),
+                "Queen attacks on empty board");
+}
+
+// ============================================================================
+// Test: Legal Move Generation (perft)
+// ============================================================================
+
+void test_legal_move_generation() {
+    std::cout << "\n=== Testing Legal Move Generation ===" << std::endl;
+
+    Board board;
+
+    // Kiwipete: castling, pins, promotions-in-waiting and en passant all over
+    board.load_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    test_assert(perft(board, 1) == 48, "Kiwipete perft(1) = 48");
+    test_assert(perft(board, 2) == 2039, "Kiwipete perft(2) = 2039");
+    test_assert(perft(board, 3) == 97862, "Kiwipete perft(3) = 97862");
+
+    // Horizontal en passant discovered check and rook pins
+    board.load_fen("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1");
+    test_assert(perft(board, 4) == 43238, "Position 3 perft(4) = 43238");
+
+    // Evasions, promotions with capture
+    board.load_fen("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+    test_assert(perft(board, 3) == 9467, "Position 4 perft(3) = 9467");
+
+    // Double check: only king moves
+    board.load_fen("k3r3/8/8/8/3Q4/5n2/8/4K3 w - - 0 1");
+    MoveList moves;
+    board.generate_moves(moves);
+    bool only_king = !moves.empty();
+    for (const auto move : moves) only_king &= move.from() == Square::E1;
+    test_assert(only_king, "Double check allows only king moves");
+
+    // Pinned knight cannot move
+    board.load_fen("4k3/4r3/8/8/8/8/4N3/4K3 w - - 0 1");
+    board.generate_moves(moves);
+    bool knight_moves = false;
+    for (const auto move : moves) knight_moves |= move.from() == Square::E2;
+    test_assert(!knight_moves, "Pinned knight has no moves");
+}
+
+// ============================================================================
+// Test: Capture / Quiet Generation
+// ============================================================================
+
+bool is_tactical(const Move move) {
+    return move.is_capture() || move.is_en_passant() ||
+           (move.is_promotion() && move.promotion() == PieceType::QUEEN);
+}
+
+// Captures and quiets must partition the legal moves, in every node of the tree
+bool captures_and_quiets_partition(const Board& board, const int depth) {
+    MoveList all, captures, quiets;
+    board.generate_moves(all);
+    board.generate_captures(captures);
+    board.generate_quiets(quiets);
+
+    if (captures.size() + quiets.size() != all.size()) return false;
+    for (const auto move : captures)
+        if (!is_tactical(move) || std::ranges::find(all, move) == all.end()) return false;
+    for (const auto move : quiets)
+        if (is_tactical(move) || std::ranges::find(all, move) == all.end()) return false;
+
+    if (depth == 0) return true;
+    for (const auto move : all) {
+        board.make_move(move);
+        const bool ok = captures_and_quiets_partition(board, depth - 1);
+        board.undo_move();
+        if (!ok) return false;
+    }
+    return true;
+}
+
+void test_capture_generation() {
+    std::cout << "\n=== Testing Capture/Quiet Generation ===" << std::endl;
+
+    Board board;
+    board.load_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    test_assert(captures_and_quiets_partition(board, 2), "Kiwipete: captures + quiets = legal moves");
+
+    board.load_fen("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+    test_assert(captures_and_quiets_partition(board, 2), "Position 4: captures + quiets = legal moves");
+
+    // Promotion by push and by capture: only the queen promotions are tactical
+    board.load_fen("1n5k/P7/8/8/8/8/8/7K w - - 0 1");
+    MoveList captures;
+    board.generate_captures(captures);
+    test_assert(captures.size() == 2, "Queen promotions (push and capture) are the only tactical moves");
+}
+
+// ============================================================================
+// Test: Mailbox Consistency
+// ============================================================================
+
+// piece_at (mailbox) must agree with pieces_of_type (bitboards) on every square
+bool mailbox_matches_bitboards(const Board& board) {
+    std::array<Piece, 64> expected;
+    expected.fill(Piece::NONE);
+    for (const Color color : {Color::WHITE, Color::BLACK})
+        for (int pt = 0; pt < 6; ++pt)
+            for (const Square sq : board.pieces_of_type(color, (PieceType)pt))
+                expected[(int)sq] = (Piece)((int)color * 6 + pt);
+
+    for (int sq = 0; sq < 64; ++sq)
+        if (board.piece_at((Square)sq) != expected[sq]) return false;
+    return true;
+}
+
+void test_mailbox_consistency() {
+    std::cout << "\n=== Testing Mailbox Consistency ===" << std::endl;
+
+    Board board;
+    board.load_fen("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+
+    bool consistent = mailbox_matches_bitboards(board);
+    MoveList moves, replies;
+    board.generate_moves(moves);
+    for (const auto move : moves) {
+        board.make_move(move);
+        consistent &= mailbox_matches_bitboards(board);
+
+        board.generate_moves(replies);
+        for (const auto reply : replies) {
+            board.make_move(reply);
+            consistent &= mailbox_matches_bitboards(board);
+            board.undo_move();
+        }
+
+        board.undo_move();
+        consistent &= mailbox_matches_bitboards(board);
+    }
+
+    test_assert(consistent, "Mailbox tracks bitboards through make/undo (promotions, castling, captures)");
+}
+
+void test_perft_driver() {
+    std::cout << "\n=== Testing Perft Driver ===" << std::endl;
+
+    Board board;
+    board.load_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    test_assert(perft(board, 0) == 1, "perft(0) = 1");
+    test_assert(perft(board, 3, {.threads = 4, .hash_mb = 4}) == 97862, "Threaded hashed perft(3) = 97862");
+
+    const auto split = divide(board, 2);
+    uint64_t total = 0;
+    bool round_trips = true;
+    for (const auto& [move, nodes] : split) {
+        total += nodes;
+        const Move parsed = Move::from_uci(move.to_uci());
+        round_trips &= parsed.from() == move.from() && parsed.to() == move.to() &&
+                       parsed.promotion() == move.promotion();
+    }
+    test_assert(split.size() == 48 && total == 2039, "divide(2) sums to perft(2) over 48 root moves");
+    test_assert(round_trips, "UCI strings round-trip from/to/promotion");
+    test_assert(Move(Square::E7, Square::E8, MoveFlag::PROMOTION, PieceType::KNIGHT).to_uci() == "e7e8n",
+                "Promotion UCI string carries the piece");
+}
+
+void test_unchecked_make_unmake() {
+    std::cout << "\n=== Testing Unchecked Make/Unmake and Null Move ===" << std::endl;
+
+    Board board;
+    board.load_fen("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+    const std::string fen = board.to_fen();
+    const Hash hash = board.zobrist_hash();
+    const Hash pawn_hash = board.pawn_hash();
+    test_assert(pawn_hash == ZobristHasher::compute_pawns(board.position()), "Pawn hash set from FEN");
+
+    // Every legal move, including promotions, hashes the same as the position parsed fresh
+    MoveList moves;
+    board.generate_moves(moves);
+    bool hashes_match = true;
+    bool restored = true;
+    for (const auto move : moves) {
+        board.make_move_unchecked(move);
+        Board fresh;
+        fresh.load_fen(board.to_fen());
+        hashes_match &= fresh.zobrist_hash() == board.zobrist_hash() && fresh.pawn_hash() == board.pawn_hash();
+        board.undo_move_unchecked();
+        restored &= board.to_fen() == fen && board.zobrist_hash() == hash && board.pawn_hash() == pawn_hash;
+    }
+    test_assert(hashes_match, "Incremental hashes match FEN hashes after every move (promotions too)");
+    test_assert(restored, "Unchecked unmake restores position and hashes");
+
+    // Validating make_move rejects a move that leaves the king in check and keeps the board intact
+    board.load_fen("4k3/8/8/8/8/8/4r3/4K3 w - - 0 1");
+    bool threw = false;
+    try { board.make_move(Move(Square::E1, Square::F1)); } catch (const std::invalid_argument&) { threw = true; }
+    test_assert(!threw, "Legal king move accepted");
+    board.undo_move();
+    threw = false;
+    try { board.make_move(Move(Square::E1, Square::D2)); } catch (const std::invalid_argument&) { threw = true; }
+    test_assert(threw && board.to_fen() == "4k3/8/8/8/8/8/4r3/4K3 w - - 0 1", "Illegal move rejected, board unchanged");
+
+    // ... and moves no piece could make: from an empty square, a rook through its own pawn
+    board.reset();
+    const std::string start = board.to_fen();
+    threw = false;
+    try { board.make_move(Move(Square::E4, Square::E5)); } catch (const std::invalid_argument&) { threw = true; }
+    test_assert(threw && !board.is_legal_move(Move(Square::E4, Square::E5)), "Move from an empty square rejected");
+    threw = false;
+    try { board.make_move(Move(Square::A1, Square::A5)); } catch (const std::invalid_argument&) { threw = true; }
+    test_assert(threw && !board.is_legal_move(Move(Square::A1, Square::A5)), "Rook through its own pawn rejected");
+    test_assert(board.to_fen() == start, "Board unchanged by rejected moves");
+
+    // Null move: side flips, en passant lapses, undo restores everything
+    board.load_fen("rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR b KQkq - 0 2");
+    board.make_move(Move(Square::F7, Square::F5));
+    const std::string before_null = board.to_fen();
+    const Hash hash_before_null = board.zobrist_hash();
+    board.make_null_move();
+    Board passed;
+    passed.load_fen("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR b KQkq - 1 3");
+    test_assert(board.side_to_move() == Color::BLACK && board.en_passant_square() == Square::INVALID,
+                "Null move passes the turn and clears en passant");
+    test_assert(board.zobrist_hash() == passed.zobrist_hash(), "Null move hash matches the passed position");
+    test_assert(board.to_fen() == passed.to_fen(), "Null move FEN matches the passed position");
+    board.undo_null_move();
+    test_assert(board.to_fen() == before_null && board.zobrist_hash() == hash_before_null,
+                "Undo null move restores position and hash");
+}
+
+void test_has_legal_move() {
+    std::cout << "\n=== Testing Early-Exit Legal Move Detection ===" << std::endl;
+
+    Board board;
+    bool agrees = true;
+    for (const char* fen : {
+             "rnbqkbnr/ppppp2p/8/5ppQ/4P3/2N5/PPPP1PPP/R1B1KBNR b KQkq - 1 3",  // Checkmate
+             "7k/5Q2/6K1/8/8/8/8/8 b - - 0 1",                                 // Stalemate
+             "7k/8/8/8/8/8/p7/K1q5 w - - 0 1",                                 // Checkmate
+             "k7/8/8/8/8/8/1qP5/K7 w - - 0 1",                                 // Only Kxb2 remains
+             "8/8/8/8/8/5k2/4p3/4K3 w - - 0 1",                                // King has one escape
+             "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+         }) {
+        board.load_fen(fen);
+        MoveList moves;
+        board.generate_moves(moves);
+        agrees &= board.has_legal_move() == !moves.empty();
+    }
+    test_assert(agrees, "has_legal_move() agrees with generate_moves() on terminal and near-terminal positions");
+
+    board.load_fen("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1");
+    test_assert(board.is_stalemate() && !board.is_checkmate(), "Stalemate detected without full generation");
+}
+
+void test_static_exchange() {
+    std::cout << "\n=== Testing Static Exchange Evaluation ===" << std::endl;
+
+    Board board;
+
+    board.load_fen("1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - - 0 1");
+    const Move rxe5(Square::E1, Square::E5, MoveFlag::CAPTURE);
+    test_assert(board.see(rxe5) == 100, "Undefended pawn is won outright");
+
+    board.load_fen("1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 1");
+    const Move nxe5(Square::D3, Square::E5, MoveFlag::CAPTURE);
+    test_assert(board.see(nxe5) == 100 - 320, "Knight for pawn once the whole exchange plays out");
+    test_assert(!board.see_ge(nxe5, 0) && board.see_ge(nxe5, -220), "see_ge agrees with see on a losing capture");
+
+    // The rook on d1 only joins once the one on d2 has captured
+    board.load_fen("3rk3/8/8/3p4/8/8/3R4/3RK3 w - - 0 1");
+    const Move rxd5(Square::D2, Square::D5, MoveFlag::CAPTURE);
+    test_assert(board.see(rxd5) == 100, "X-ray rook backs up the capture");
+    test_assert(board.see_ge(rxd5, 100) && !board.see_ge(rxd5, 101), "see_ge threshold is exact");
+
+    bool agrees = true;
+    for (const char* fen : {
+             "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+             "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+             "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+         }) {
+        board.load_fen(fen);
+        MoveList captures;
+        board.generate_captures(captures);
+        for (const Move m : captures)
+            for (int threshold = -1000; threshold <= 1000; threshold += 10)
+                agrees &= board.see_ge(m, threshold) == (board.see(m) >= threshold);
+    }
+    test_assert(agrees, "see_ge(move, t) == (see(move) >= t) for every capture and threshold");
+}
+
+void test_position_snapshot() {
+    std::cout << "\n=== Testing Position Snapshots ===" << std::endl;
+
+    Board board;
+    board.load_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    const Position snapshot = board.position();
+
+    const Board restored(snapshot);
+    test_assert(restored.to_fen() == board.to_fen() && restored.zobrist_hash() == board.zobrist_hash(),
+                "Board(Position) reproduces the snapshot");
+    test_assert(restored.move_history().empty(), "Snapshot board starts with an empty history");
+
+    Board other;
+    other.reset();
+    other.make_move(Move(Square::E2, Square::E4));
+    other.set_position(snapshot);
+    test_assert(other.to_fen() == board.to_fen() && other.move_history().empty(),
+                "set_position() loads the snapshot and clears the history");
+
+    // Copy-make: restoring the pre-move snapshot is the same as unmaking
+    MoveList moves;
+    board.generate_moves(moves);
+    bool same = true;
+    for (const auto move : moves) {
+        board.make_move_unchecked(move);
+        board.undo_move_to(snapshot);
+        same &= board.to_fen() == restored.to_fen() && board.move_history().empty();
+    }
+    test_assert(same, "undo_move_to() restores the snapshot and pops the history");
+}
+
+void test_piece_iteration() {
+    std::cout << "\n=== Testing Piece Iteration ===" << std::endl;
+
+    Board board;
+    board.load_fen("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+
+    bool matches = true;
+    for (const Color color : {Color::WHITE, Color::BLACK}) {
+        for (int type = 0; type < 6; ++type) {
+            const auto squares = board.pieces_of_type(color, (PieceType)type);
+            const Squares set(board.pieces(color, (PieceType)type));
+            matches &= set.size() == (int)squares.size();
+
+            size_t i = 0;
+            for (const Square sq : set)
+                matches &= i < squares.size() && squares[i++] == sq;
+        }
+    }
+    test_assert(matches, "Squares(pieces()) visits the same squares as pieces_of_type()");
+    test_assert(Squares(board.occupancy(Color::WHITE)).size() ==
+                (int)board.pieces_of_color(Color::WHITE).size(), "occupancy() counts every white piece");
+    test_assert(Squares(0).empty(), "Empty bitboard yields no squares");
+
+    // Hash computed from scratch must agree with the incrementally updated one
+    board.reset();
+    board.make_move(Move(Square::E2, Square::E4));
+    board.make_move(Move(Square::E7, Square::E5));
+    board.make_move(Move(Square::G1, Square::F3));
+    Board fresh;
+    fresh.load_fen(board.to_fen());
+    test_assert(fresh.zobrist_hash() == board.zobrist_hash(), "Hash from FEN matches hash after moves");
+}
+
+// ============================================================================
+// Test: SAN, PGN and EPD reading
+// ============================================================================
+
+const std::string PGN_SAMPLE = R"([Event "Paris"]
+[White "Morphy, Paul"]
+[Black "Duke Karl / Count Isouard"]
+[Result "1-0"]
+
+1.e4 e5 2.Nf3 d6 3.d4 Bg4 {the pin} (3...exd4 4.Nxd4) 4.dxe5 Bxf3 5.Qxf3 dxe5
+6.Bc4 Nf6 7.Qb3 Qe7 8.Nc3 c6 9.Bg5 b5 $2 10.Nxb5 cxb5 11.Bxb5+ Nbd7 12.O-O-O Rd8
+13.Rxd7 Rxd7 14.Rd1 Qe6 15.Bxd7+ Nxd7 16.Qb8+ Nxb8 17.Rd8# 1-0
+
+[Event "en passant, no result"]
+
+1. e4 d5 2. e5 f5 3. exf6 ; to the end of the line
+gxf6
+
+[Event "promotion"]
+[FEN "4k3/1P6/8/8/8/8/8/4K3 w - - 0 1"]
+[Annotator "a \"quoted\" name"]
+
+1. b8=Q+ Kd7 2. Qb5+ *
+)";
+
+void test_pgn_and_epd() {
+    std::cout << "\n=== Testing SAN, PGN and EPD ===" << std::endl;
+
+    Board board;
+    board.load_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    test_assert(board.parse_san("O-O-O").flag() == MoveFlag::CASTLING, "SAN castling");
+    test_assert(board.parse_san("Nxf7").to_uci() == "e5f7", "SAN capture");
+    test_assert(board.parse_san("Bxa6!?").to_uci() == "e2a6", "SAN annotation marks ignored");
+    const auto throws = [&board](const std::string& san) {
+        try { (void)board.parse_san(san); } catch (const std::invalid_argument&) { return true; }
+        return false;
+    };
+    test_assert(throws("Ke3") && throws("Nb6") && throws("Qz9"), "Illegal and invalid SAN rejected");
+    board.load_fen("4k3/8/8/R7/8/8/4K3/R6R w - - 0 1");
+    test_assert(throws("Rd1") && throws("Ra3"), "Ambiguous SAN rejected");
+    test_assert(board.parse_san("Rhd1").to_uci() == "h1d1" && board.parse_san("R1a3").to_uci() == "a1a3" &&
+                board.parse_san("R5a3").to_uci() == "a5a3", "SAN disambiguation by file or rank");
+    board.load_fen("8/1P6/8/8/8/8/8/k3K3 w - -");
+    test_assert(board.halfmove_clock() == 0 && board.fullmove_number() == 1, "FEN clocks optional");
+    test_assert(board.parse_san("b8=N").promotion() == PieceType::KNIGHT && board.parse_san("b8Q").promotion() == PieceType::QUEEN,
+                "SAN promotions");
+
+    PgnReader reader(PGN_SAMPLE);
+    PgnGame game;
+    test_assert(reader.next(game) && game.tags.size() == 4 && game.tag("White") == "Morphy, Paul" && game.result == "1-0",
+                "PGN tags and result");
+    size_t callbacks = 0;
+    std::string first_move;
+    const size_t plies = PgnReader::replay(game, board, [&](const Board& b, const Move m) {
+        if (callbacks++ == 0) first_move = m.to_uci() + (b.side_to_move() == Color::WHITE ? "w" : "b");
+    });
+    test_assert(plies == 33 && callbacks == 33 && first_move == "e2e4w", "PGN replay skips comments, variations and NAGs");
+    test_assert(board.is_checkmate(), "PGN replay reaches the final mate");
+
+    test_assert(reader.next(game) && game.result.empty() && PgnReader::replay(game, board) == 6, "PGN game without a result");
+    test_assert(board.piece_at(Square::F5) == Piece::NONE && board.piece_at(Square::F6) == Piece::BLACK_PAWN,
+                "PGN en passant replayed");
+
+    test_assert(reader.next(game) && game.tag("Annotator") == R"(a \"quoted\" name)" && game.result == "*",
+                "PGN escaped tag value");
+    test_assert(PgnReader::replay(game, board) == 3 && board.piece_at(Square::B5) == Piece::WHITE_QUEEN,
+                "PGN replay from a FEN tag");
+    test_assert(!reader.next(game) && reader.offset() == PGN_SAMPLE.size(), "PGN reader ends");
+
+    // A stray comment closer is skipped like a stray ']', in or out of a variation
+    PgnReader stray("[Event \"x\"]\n\n1. e4 } e5 1-0\n1. e4 (1. d4 }) e5 1-0\n");
+    bool strays_skipped = true;
+    for (int i = 0; i < 2; ++i)
+        strays_skipped = strays_skipped && stray.next(game) && game.result == "1-0" && PgnReader::replay(game, board) == 2;
+    test_assert(strays_skipped && !stray.next(game), "PGN stray '}' skipped");
+
+    const std::string epd = "  \n# corpus\nrnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 bm e5; id \"x;y\";\n"
+                            "8/8/8/8/8/8/8/K6k w - - 3 9\n";
+    EpdReader epd_reader(epd);
+    EpdRecord record;
+    test_assert(epd_reader.next(record) && record.clocks.empty() && record.operation("id") == "x;y" &&
+                record.operation("bm") == "e5" && !record.operation("ce"), "EPD operations");
+    board.load_fen(record.fen);
+    test_assert(board.en_passant_square() == Square::E3, "EPD position loads");
+    test_assert(epd_reader.next(record) && record.clocks == "3 9" && record.operations.empty(), "FEN line in EPD");
+    test_assert(!epd_reader.next(record), "EPD reader ends");
+}
+
+// ============================================================================
+// Test: Packed positions
+// ============================================================================
+
+void test_packed_position() {
+    std::cout << "\n=== Testing Packed Positions ===" << std::endl;
+
+    const auto same = [](const Position& a, const Position& b) {
+        return a.zobrist_hash == b.zobrist_hash && a.pawn_hash == b.pawn_hash &&
+               a.psq_midgame == b.psq_midgame && a.psq_endgame == b.psq_endgame &&
+               a.material[0] == b.material[0] && a.material[1] == b.material[1] && a.phase == b.phase &&
+               std::equal(std::begin(a.mailbox), std::end(a.mailbox), std::begin(b.mailbox)) &&
+               Board(a).to_fen() == Board(b).to_fen();
+    };
+
+    // Every position of a game survives the round trip
+    PgnReader reader(PGN_SAMPLE);
+    PgnGame game;
+    Board board;
+    std::vector<PackedPosition> packed;
+    bool all_same = true;
+    while (reader.next(game)) {
+        PgnReader::replay(game, board, [&](const Board& b, Move) {
+            packed.push_back(PackedPosition::pack(b.position()));
+            all_same = all_same && same(packed.back().unpack(), b.position());
+        });
+    }
+    test_assert(all_same && packed.size() == 42, "Packed positions unpack to the same Position");
+
+    board.load_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 12 345");
+    packed.push_back(PackedPosition::pack(board.position()));
+    test_assert(Board(packed.back().unpack()).to_fen() == board.to_fen(), "Castling rights and clocks packed");
+
+    // Bulk write, stream read and in-place view
+    const std::string path = (std::filesystem::temp_directory_path() / "chess_board_tests.pos").string();
+    {
+        std::ofstream out(path, std::ios::binary);
+        PackedPosition::write(out, packed);
+    }
+    std::vector<PackedPosition> read_back(packed.size() + 5);
+    std::ifstream in(path, std::ios::binary);
+    test_assert(PackedPosition::read(in, read_back) == packed.size() &&
+                std::memcmp(read_back.data(), packed.data(), packed.size() * sizeof(PackedPosition)) == 0,
+                "Packed positions read back in bulk");
+    {
+        const internal::MappedFile file(path);
+        const auto view = PackedPosition::view(file);
+        test_assert(view.size() == packed.size() && same(view[5].unpack(), packed[5].unpack()), "Mapped file viewed in place");
+    }
+    std::filesystem::remove(path);
+
+    PackedPosition corrupt = packed[0];
+    corrupt.pieces[0] = 0xFF;
+    bool threw = false;
+    try { (void)corrupt.unpack(); } catch (const std::invalid_argument&) { threw = true; }
+    test_assert(threw, "Corrupt record rejected");
+}
+
 // ============================================================================
 // Main Test Runner
 // ============================================================================
@@ -536,6 +1102,18 @@ int main() {
         // test_position_validation(); // TODO: Implement position validation logic before enabling this test
         test_game_result();
         test_display();
+        test_sliding_attacks();
+        test_legal_move_generation();
+        test_capture_generation();
+        test_mailbox_consistency();
+        test_piece_iteration();
+        test_perft_driver();
+        test_unchecked_make_unmake();
+        test_has_legal_move();
+        test_position_snapshot();
+        test_static_exchange();
+        test_pgn_and_epd();
+        test_packed_position();
         
         std::cout << "\n╔════════════════════════════════════════╗" << std::endl;
         std::cout << "║          ✓ ALL TESTS PASSED            ║" << std::endl;
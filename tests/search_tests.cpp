@@ -1,9 +1,26 @@
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
 
+#include "chess/BatchAnalyzer.hpp"
 #include "chess/Board.hpp"
+#include "chess/EnginePool.hpp"
 #include "chess/Eval.hpp"
+#include "chess/OpeningBook.hpp"
+#include "chess/PawnStructure.hpp"
 #include "chess/Search.hpp"
+#include "chess/Tablebase.hpp"
+#include "chess/TranspositionTable.hpp"
 
 using namespace chess;
 using namespace std::chrono_literals;
@@ -18,29 +35,527 @@ void test_evaluator() {
     board.reset();
     int eval = evaluator.evaluate(board);
     std::cout << "Starting position: " << eval << " (should be 0)" << std::endl;
-    assert(eval == 0);
+    assert(eval == 0 && evaluator.evaluate_white(board) == 0);
     
-    // Test 2: White up a pawn
-    board.load_fen("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1");
+    // Test 2: White up a pawn (black's e-pawn is gone), scored for the side to move
+    board.load_fen("rnbqkbnr/pppp1ppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
     eval = evaluator.evaluate(board);
     std::cout << "White up a pawn: " << eval << " (should be ~100)" << std::endl;
-    assert(eval == 100);  // One pawn difference
+    assert(eval > 50 && eval < 200);
+    assert(evaluator.evaluate_white(board) == eval && evaluator.material_count(board) == 100);
+
+    board.load_fen("rnbqkbnr/pppp1ppp/8/8/8/8/PPPPPPPP/RNBQKBNR b KQkq - 0 1");
+    assert(evaluator.evaluate(board) == -eval && evaluator.evaluate_white(board) == eval);
+    assert(evaluator.material_count(board) == -100);
     
-    // Test 3: White up a rook
-    board.load_fen("rnbqkbn1/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQq - 0 1");
-    eval = evaluator.evaluate(board);
+    // Test 3: White up a rook, black to move
+    board.load_fen("rnbqkbn1/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR b KQq - 0 1");
+    eval = evaluator.evaluate_white(board);
     std::cout << "White up a rook: " << eval << " (should be ~500)" << std::endl;
-    assert(eval == 500);
-    
-    // Test 4: Checkmate
-    board.load_fen("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1");
-    eval = evaluator.evaluate(board);
-    std::cout << "Black checkmated: " << eval << " (should be CHECKMATE)" << std::endl;
-    assert(eval == CHECKMATE);
+    assert(eval > 400 && eval < 600);
+    assert(evaluator.evaluate(board) == -eval);
     
     std::cout << "✓ All evaluator tests passed!" << std::endl;
 }
 
+void test_incremental_evaluation() {
+    std::cout << "\n=== Testing Incremental Evaluation ===" << std::endl;
+
+    Board board;
+    Evaluator evaluator;
+
+    // Play through captures, castling and a promotion, then compare the
+    // incrementally maintained eval against a board parsed from scratch
+    board.load_fen("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+    [[maybe_unused]] const Score initial = evaluator.evaluate(board);
+
+    MoveList moves;
+    board.generate_moves(moves);
+    for (const auto move : moves) {
+        board.make_move(move);
+
+        Board fresh;
+        fresh.load_fen(board.to_fen());
+        assert(evaluator.evaluate(board) == evaluator.evaluate(fresh));
+        assert(evaluator.get_phase(board) == evaluator.get_phase(fresh));
+        assert(evaluator.evaluate_white(board) == -evaluator.evaluate(board));
+
+        board.undo_move();
+    }
+    assert(evaluator.evaluate(board) == initial);
+
+    std::cout << "✓ Incremental eval matches full recomputation!" << std::endl;
+}
+
+void test_pawn_structure() {
+    std::cout << "\n=== Testing Pawn Structure ===" << std::endl;
+
+    Board board;
+
+    // Symmetric structures cancel out
+    board.load_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    [[maybe_unused]] PawnScore score = evaluate_pawn_structure(board.position());
+    assert(score.midgame == 0 && score.endgame == 0);
+
+    // A lone passer on the sixth outweighs anything else in the endgame
+    board.load_fen("4k3/8/P7/8/8/8/8/4K3 w - - 0 1");
+    score = evaluate_pawn_structure(board.position());
+    assert(score.endgame > 50);
+
+    // Doubled, isolated c-pawns for white against a healthy chain
+    board.load_fen("4k3/5ppp/8/8/2P5/2P5/8/4K3 w - - 0 1");
+    [[maybe_unused]] const PawnScore weak = evaluate_pawn_structure(board.position());
+    board.load_fen("4k3/5ppp/8/8/8/1PP5/8/4K3 w - - 0 1");
+    [[maybe_unused]] const PawnScore healthy = evaluate_pawn_structure(board.position());
+    assert(weak.midgame < healthy.midgame && weak.endgame < healthy.endgame);
+
+    // The shield counts pawns in front of a castled king only
+    board.load_fen("6k1/8/8/8/8/8/5PPP/6K1 w - - 0 1");
+    [[maybe_unused]] const Score sheltered = king_pawn_shield(board.position(), Color::WHITE);
+    board.load_fen("6k1/8/8/8/8/4K3/5PPP/8 w - - 0 1");
+    assert(sheltered > 0 && king_pawn_shield(board.position(), Color::WHITE) == 0);
+
+    // Cached and fresh results agree, including after the table wraps
+    PawnHashTable table(64);
+    for (const char* fen : {
+             "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+             "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+             "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+         }) {
+        board.load_fen(fen);
+        MoveList moves;
+        board.generate_moves(moves);
+        for (const Move move : moves) {
+            board.make_move(move);
+            for (int probe = 0; probe < 2; ++probe) {
+                [[maybe_unused]] const PawnScore cached = table.probe(board.position());
+                [[maybe_unused]] const PawnScore fresh = evaluate_pawn_structure(board.position());
+                assert(cached.midgame == fresh.midgame && cached.endgame == fresh.endgame);
+            }
+            board.undo_move();
+        }
+    }
+
+    std::cout << "✓ Pawn structure terms and pawn hash work!" << std::endl;
+}
+
+/// A network of the right shape with small random weights, written to a temp file
+std::string write_random_network() {
+    std::vector<char> bytes(NnueNetwork::FILE_BYTES, 0);
+    const uint32_t header[4] = { NnueNetwork::MAGIC, NnueNetwork::VERSION, nnue::KING_BUCKETS, nnue::HIDDEN };
+    std::memcpy(bytes.data(), header, sizeof(header));
+
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<int> weight(-40, 40);
+    for (size_t offset = NnueNetwork::HEADER_BYTES; offset + 2 <= bytes.size() - sizeof(int32_t); offset += 2) {
+        const auto w = (int16_t)weight(rng);
+        std::memcpy(bytes.data() + offset, &w, sizeof(w));
+    }
+
+    const std::string path = (std::filesystem::temp_directory_path() / "chess_test_network.nnue").string();
+    std::ofstream(path, std::ios::binary).write(bytes.data(), (std::streamsize)bytes.size());
+    return path;
+}
+
+/// Walk every line to `depth`, checking the incrementally updated eval against a full refresh
+bool nnue_matches_refresh(const Evaluator& evaluator, const Board& board, const int depth) {
+    Board fresh;
+    fresh.load_fen(board.to_fen());
+    if (evaluator.evaluate(board) != evaluator.evaluate(fresh))
+        return false;
+    if (depth == 0)
+        return true;
+
+    MoveList moves;
+    board.generate_moves(moves);
+    bool ok = true;
+    for (const Move move : moves) {
+        board.make_move_unchecked(move);
+        ok &= nnue_matches_refresh(evaluator, board, depth - 1);
+        board.undo_move_unchecked();
+    }
+    return ok;
+}
+
+void test_nnue_evaluation() {
+    std::cout << "\n=== Testing NNUE Evaluation ===" << std::endl;
+
+    [[maybe_unused]] bool threw = false;
+    try { (void)NnueNetwork::load("/nonexistent/network.nnue"); } catch (const std::runtime_error&) { threw = true; }
+    assert(threw);
+
+    const std::string path = write_random_network();
+    const std::shared_ptr<const NnueNetwork> network = NnueNetwork::load(path);
+
+    Evaluator evaluator;
+    evaluator.set_network(network);
+
+    // Castling, promotions, en passant and king moves across buckets
+    for (const char* fen : {
+             "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+             "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+             "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+         }) {
+        Board board;
+        board.attach_network(network);
+        board.load_fen(fen);
+        [[maybe_unused]] const bool matches = nnue_matches_refresh(evaluator, board, 3);
+        assert(matches);
+
+        // A null move keeps the stack in step too
+        if (!board.is_in_check()) {
+            board.make_null_move();
+            Board passed;
+            passed.load_fen(board.to_fen());
+            assert(evaluator.evaluate(board) == evaluator.evaluate(passed));
+            board.undo_null_move();
+        }
+    }
+
+    // Searches with the network, copy-make and Lazy SMP included
+    SearchConfig config;
+    config.threads = 2;
+    config.use_copy_make = true;
+    Engine engine(config);
+    engine.set_network(network);
+    Board board;
+    board.load_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    [[maybe_unused]] const SearchResult result = engine.find_best_move(board, (Depth)5);
+    MoveList legal;
+    board.generate_moves(legal);
+    assert(std::ranges::find(legal, result.best_move) != legal.end());
+
+    // Detaching goes back to the piece-square tables
+    engine.set_network(nullptr);
+    Evaluator classical;
+    assert(engine.evaluate(board) == classical.evaluate(board));
+
+    std::filesystem::remove(path);
+    std::cout << "✓ Incremental NNUE accumulators match full refreshes!" << std::endl;
+}
+
+/// Polyglot book file from (fen, uci move, weight) entries, sorted by key as the format requires
+std::string write_book(const std::vector<std::tuple<std::string, std::string, uint16_t>>& lines) {
+    std::vector<std::array<uint8_t, OpeningBook::ENTRY_BYTES>> entries;
+    for (const auto& [fen, uci, weight] : lines) {
+        Board board;
+        board.load_fen(fen);
+        const uint64_t key = OpeningBook::key(board.position());
+
+        // Encode from the UCI text; e1h1 style castling stays as written
+        const Move m = Move::from_uci(uci);
+        const uint16_t move = OpeningBook::encode_move(m);
+
+        std::array<uint8_t, OpeningBook::ENTRY_BYTES> entry {};
+        for (int i = 0; i < 8; ++i) entry[i] = (uint8_t)(key >> (56 - 8 * i));
+        entry[8] = (uint8_t)(move >> 8);
+        entry[9] = (uint8_t)move;
+        entry[10] = (uint8_t)(weight >> 8);
+        entry[11] = (uint8_t)weight;
+        entries.push_back(entry);
+    }
+    std::ranges::stable_sort(entries, [](const auto& a, const auto& b) {
+        return std::lexicographical_compare(a.begin(), a.begin() + 8, b.begin(), b.begin() + 8);
+    });
+
+    const std::string path = (std::filesystem::temp_directory_path() / "chess_test_book.bin").string();
+    std::ofstream out(path, std::ios::binary);
+    for (const auto& entry : entries)
+        out.write(reinterpret_cast<const char*>(entry.data()), (std::streamsize)entry.size());
+    return path;
+}
+
+void test_opening_book() {
+    std::cout << "\n=== Testing Opening Book ===" << std::endl;
+
+    const std::string start = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    const std::string castles = "r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1";
+    const std::string path = write_book({
+        { castles, "e1h1", 1 },
+        { start, "d2d4", 5 },
+        { start, "e2e4", 10 },
+        { start, "e2e5", 50 },      // Not a legal move: skipped
+    });
+    const std::shared_ptr<const OpeningBook> book = OpeningBook::open(path);
+    assert(book->size() == 4);
+
+    Board board;
+    board.load_fen(start);
+    assert(book->moves(board).size() == 2);
+
+    // Best takes the heaviest legal move, weighted eventually plays both
+    std::mt19937_64 rng(7);
+    assert(book->probe(board, BookSelection::BEST, rng)->to_uci() == "e2e4");
+    int e4_count = 0;
+    for (int i = 0; i < 300; ++i)
+        e4_count += book->probe(board, BookSelection::WEIGHTED, rng)->to_uci() == "e2e4";
+    assert(e4_count > 120 && e4_count < 280);
+
+    // King-takes-rook castling is decoded to the engine's king move
+    board.load_fen(castles);
+    [[maybe_unused]] const std::optional<Move> castle = book->probe(board, BookSelection::BEST, rng);
+    assert(castle && castle->flag() == MoveFlag::CASTLING && castle->to() == Square::G1);
+
+    // An en passant square nobody can capture on doesn't change the key
+    Board with_ep, without_ep;
+    with_ep.load_fen("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1");
+    without_ep.load_fen("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1");
+    assert(OpeningBook::key(with_ep.position()) == OpeningBook::key(without_ep.position()));
+    board.load_fen("rnbqkbnr/pppp1ppp/8/8/3Pp3/8/PPP1PPPP/RNBQKBNR b KQkq d3 0 1");
+    without_ep.load_fen("rnbqkbnr/pppp1ppp/8/8/3Pp3/8/PPP1PPPP/RNBQKBNR b KQkq - 0 1");
+    assert(OpeningBook::key(board.position()) != OpeningBook::key(without_ep.position()));
+
+    // Keys match any Polyglot book: the reference positions of the format's specification
+    const std::pair<const char*, uint64_t> reference_keys[] = {
+        { "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 0x463b96181691fc9cULL },
+        { "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1", 0x823c9b50fd114196ULL },
+        { "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3", 0x22a48b5a8e47ff78ULL },
+        { "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPPKPPP/RNBQ1BNR b kq - 0 3", 0x652a607ca3f242c1ULL },
+        { "rnbq1bnr/ppp1pkpp/8/3pPp2/8/8/PPPPKPPP/RNBQ1BNR w - - 0 4", 0x00fdd303c946bdd9ULL },
+        { "rnbqkbnr/p1pppppp/8/8/PpP4P/8/1P1PPPP1/RNBQKBNR b KQkq c3 0 3", 0x3c8123ea7b067637ULL },
+        { "rnbqkbnr/p1pppppp/8/8/P6P/R1p5/1P1PPPP1/1NBQKBNR b Kkq - 0 4", 0x5c3f9b829b279560ULL },
+    };
+    for ([[maybe_unused]] const auto& [fen, key] : reference_keys) {
+        board.load_fen(fen);
+        assert(OpeningBook::key(board.position()) == key);
+    }
+
+    // Timed searches play from the book without searching; engines share one mapping
+    SearchConfig config;
+    config.book = book;
+    config.book_selection = BookSelection::BEST;
+    const Engine first(config), second(config);
+    board.load_fen(start);
+    [[maybe_unused]] const SearchResult booked = first.find_best_move(board, 1000ms);
+    assert(booked.best_move.to_uci() == "e2e4" && booked.nodes_searched == 0);
+    assert(second.find_best_move(board, 1000ms).best_move == booked.best_move);
+
+    // Out of book, and fixed-depth analysis, search as usual
+    board.make_move(booked.best_move);
+    assert(first.find_best_move(board, 100ms).nodes_searched > 0);
+    board.undo_move();
+    assert(first.find_best_move(board, (Depth)3).nodes_searched > 0);
+
+    std::filesystem::remove(path);
+    std::cout << "✓ Book probes, castling decode and engine integration work!" << std::endl;
+}
+
+void test_tablebase() {
+    std::cout << "\n=== Testing Tablebase ===" << std::endl;
+
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "chess_search_tests_tb";
+    Tablebase::generate(dir.string());
+    const std::shared_ptr<const Tablebase> tb = Tablebase::open(dir.string());
+    assert(tb->cardinality() == 3);
+
+    const auto probe = [&](const std::string& fen) {
+        Board board;
+        board.load_fen(fen);
+        return tb->probe(board.position());
+    };
+
+    // Mate in one, a pawn that queens, a blocked pawn and mirrored colors
+    [[maybe_unused]] const auto mate = probe("4k3/8/4K3/8/8/8/8/7R w - - 0 1");
+    assert(mate && mate->wdl == Wdl::WIN && mate->dtm == 1);
+    [[maybe_unused]] const auto queens = probe("8/4P3/8/8/8/8/k7/4K3 w - - 0 1");
+    assert(queens && queens->wdl == Wdl::WIN);
+    [[maybe_unused]] const auto blocked = probe("8/8/8/8/8/4k3/4P3/4K3 w - - 0 1");
+    assert(blocked && blocked->wdl == Wdl::DRAW);
+    [[maybe_unused]] const auto mirrored = probe("7r/8/8/8/8/4k3/8/4K3 w - - 0 1");
+    assert(mirrored && mirrored->wdl == Wdl::LOSS && mirrored->dtm == probe("4k3/8/4K3/8/8/8/8/7R b - - 0 1")->dtm);
+    assert(probe("4k3/8/8/8/8/8/8/4K2N w - - 0 1")->wdl == Wdl::DRAW);
+    assert(!probe("4k3/8/8/8/8/8/8/R3K3 w Q - 0 1"));
+    assert(!probe("4k3/8/8/8/8/8/8/RR2K3 w - - 0 1"));
+
+    // The search mates by the book from a position too deep for its horizon
+    SearchConfig config;
+    config.tablebase = tb;
+    const Engine engine(config);
+    Board board;
+    board.load_fen("8/8/8/3k4/8/8/8/R3K3 w - - 0 1");
+    [[maybe_unused]] const auto exact = tb->probe(board.position());
+    [[maybe_unused]] const SearchResult result = engine.find_best_move(board, (Depth)4);
+    assert(exact && exact->wdl == Wdl::WIN);
+    assert(result.score == CHECKMATE - exact->dtm);
+    board.make_move(result.best_move);
+    assert(tb->probe(board.position())->dtm == exact->dtm - 1);
+
+    std::filesystem::remove_all(dir);
+    std::cout << "✓ Generated tables probe correctly and steer the search!" << std::endl;
+}
+
+void test_batch_analysis() {
+    std::cout << "\n=== Testing Batch Analysis ===" << std::endl;
+
+    // EPD operations, quoted semicolons, FEN clocks, comments and bad operands
+    [[maybe_unused]] const auto epd = BatchAnalyzer::parse_line(
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - bm e2a6; id \"kiwi;pete\"; acd 3; hmvc 4;");
+    assert(epd && epd->depth == 3 && epd->nodes == 0 && epd->id == "kiwi;pete");
+    assert(epd->fen == "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 4 1");
+    assert(BatchAnalyzer::parse_line("8/8/8/3k4/8/8/8/R3K3 w - - 7 40 acn 500;")->fen == "8/8/8/3k4/8/8/8/R3K3 w - - 7 40");
+    assert(!BatchAnalyzer::parse_line("   ") && !BatchAnalyzer::parse_line("# corpus v2"));
+    [[maybe_unused]] bool threw = false;
+    try { (void)BatchAnalyzer::parse_line("8/8/8/3k4/8/8/8/R3K3 w - - acd x;"); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+
+    // A node limit stops the search where it is
+    SearchConfig limited;
+    limited.node_limit = 3000;
+    Board board;
+    board.load_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    [[maybe_unused]] const SearchResult cut = Engine(limited).find_best_move(board, (Depth)20);
+    assert(cut.nodes_searched >= 3000 && cut.nodes_searched < 3100 && cut.best_move != Move());
+
+    // Mixed budgets on a small pool with a shared table and little read-ahead
+    std::vector<BatchJob> jobs;
+    const char* fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1",
+    };
+    for (int i = 0; i < 12; ++i)
+        jobs.push_back({ fens[i % 4], std::to_string(i), (Depth)(i % 3 == 0 ? 0 : 3), i % 3 == 0 ? 2000u : 0u });
+    jobs.push_back({ "not a fen", "bad", 0, 0 });
+
+    BatchConfig config;
+    config.workers = 3;
+    config.max_pending = 2;
+    config.share_tt = true;
+    config.search.tt_size_mb = 4;
+    BatchAnalyzer analyzer(config);
+    assert(analyzer.worker_count() == 3);
+
+    std::vector<int> seen(jobs.size());
+    [[maybe_unused]] const size_t delivered = analyzer.run(jobs, [&](const BatchResult& r) {
+        ++seen[r.index];
+        assert(r.job.id == jobs[r.index].id);
+        if (r.job.id == "bad") {
+            assert(!r.error.empty());
+            return;
+        }
+        assert(r.error.empty());
+        Board b;
+        b.load_fen(r.job.fen);
+        assert(b.is_legal_move(r.result.best_move));
+        if (r.job.nodes) assert(r.result.nodes_searched < 2100);
+        else assert(r.result.depth == 3);
+    });
+    assert(delivered == jobs.size() && std::ranges::count(seen, 1) == (long)jobs.size());
+
+    // The pool is reusable, reads streams lazily, and a throwing callback cancels the rest
+    std::istringstream corpus("# two positions\n" + std::string(fens[0]) + " acd 2;\n\n" + fens[3] + "\n");
+    assert(analyzer.run(corpus, []([[maybe_unused]] const BatchResult& r) { assert(r.error.empty() && r.index < 2); }) == 2);
+    threw = false;
+    try {
+        (void)analyzer.run(jobs, [](const BatchResult&) { throw std::runtime_error("enough"); });
+    } catch (const std::runtime_error&) { threw = true; }
+    assert(threw);
+
+    std::cout << "✓ Batches run on the pool with budgets, errors and cancellation!" << std::endl;
+}
+
+void test_engine_pool() {
+    std::cout << "\n=== Testing Engine Pool ===" << std::endl;
+
+    // Two threads and room for three tables serve six games
+    EnginePoolConfig config;
+    config.threads = 2;
+    config.session_tt_mb = 1;
+    config.memory_mb = 3;
+    EnginePool pool(config);
+    assert(pool.thread_count() == 2 && pool.table_limit() == 3);
+
+    const char* fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    };
+    std::vector<EngineSession> sessions;
+    std::vector<Board> boards(6);
+    std::vector<PendingSearch> pending;
+    for (int i = 0; i < 6; ++i) {
+        sessions.push_back(pool.open_session());
+        boards[i].load_fen(fens[i % 3]);
+        pending.push_back(sessions[i].find_best_move(boards[i], (Depth)4));
+    }
+
+    // Every game's first search starts from an empty table, like a fresh engine's
+    SearchConfig fresh;
+    fresh.tt_size_mb = 1;
+    for (int i = 0; i < 6; ++i) {
+        [[maybe_unused]] const SearchResult result = pending[i].result.get();
+        assert(boards[i].is_legal_move(result.best_move) && result.depth == 4);
+        assert(result.nodes_searched == Engine(fresh).find_best_move(boards[i], (Depth)4).nodes_searched);
+    }
+    assert(pool.resident_tables() == 3 && pool.reclaimed_tables() >= 3);
+    assert(std::ranges::count_if(sessions, &EngineSession::resident) == 3);
+
+    // Games keep playing; a finished one hands its table to the next
+    boards[0].make_move(sessions[0].find_best_move(boards[0], (Depth)3).result.get().best_move);
+    assert(sessions[0].resident());
+    sessions[0].new_game();
+    assert(!sessions[0].resident());
+    sessions.pop_back();
+    assert(pool.resident_tables() <= pool.table_limit());
+
+    // Cancelling ends a long search promptly, still with a legal move
+    [[maybe_unused]] const auto start = std::chrono::steady_clock::now();
+    PendingSearch slow = sessions[1].find_best_move(boards[1], std::chrono::milliseconds(60000));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    slow.cancel();
+    [[maybe_unused]] const SearchResult cancelled = slow.result.get();
+    assert(boards[1].is_legal_move(cancelled.best_move));
+    assert(std::chrono::steady_clock::now() - start < std::chrono::seconds(10));
+
+    // Too small a budget for the threads is refused
+    [[maybe_unused]] bool threw = false;
+    config.memory_mb = 1;
+    try { EnginePool tiny(config); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+
+    std::cout << "✓ Sessions share the pool's threads within its memory budget!" << std::endl;
+}
+
+void test_transposition_table() {
+    std::cout << "\n=== Testing Transposition Table ===" << std::endl;
+
+    // Packed 16-bit moves round-trip, including promotions, castling and en passant
+    Board board;
+    board.load_fen("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+    MoveList moves;
+    board.generate_moves(moves);
+    for ([[maybe_unused]] const auto move : moves)
+        assert(Move::from_compact(move.compact()) == move);
+    assert(Move::from_compact(Move().compact()) == Move());
+
+    TranspositionTable tt(1);
+    const Hash deep = 0x1234'5678'9ABC'DEF0ULL;
+    [[maybe_unused]] const Move move(Square::E2, Square::E4);
+    tt.store(deep, 42, 12, LOWER_BOUND, move);
+
+    // Fill the same bucket with shallow entries: the deep one must survive
+    for (Hash i = 1; i <= 16; ++i)
+        tt.store(deep ^ (i << 48), -7, 1, UPPER_BOUND, Move());
+
+    [[maybe_unused]] const auto entry = tt.lookup(deep, 12);
+    assert(entry && entry->score == 42 && entry->flag == LOWER_BOUND && entry->best_move == move);
+    assert(!tt.lookup(deep, 13));
+
+    // A shallower result for the same position does not clobber a deeper bound
+    tt.store(deep, 5, 2, UPPER_BOUND, Move());
+    assert(tt.lookup(deep, 12)->score == 42);
+
+    // Entries from old searches age out
+    tt.new_search();
+    tt.new_search();
+    for (Hash i = 17; i <= 24; ++i)
+        tt.store(deep ^ (i << 48), 0, 1, EXACT, Move());
+    assert(!tt.lookup(deep, 0));
+
+    std::cout << "✓ Bucket replacement keeps deep entries and ages old ones!" << std::endl;
+}
+
 void test_search_starting_position() {
     std::cout << "\n=== Testing Search - Starting Position ===" << std::endl;
     
@@ -125,17 +640,306 @@ void test_search_depth() {
     std::cout << "✓ Search at various depths completed!" << std::endl;
 }
 
+void test_search_long_game() {
+    std::cout << "\n=== Testing Search - Long Game ===" << std::endl;
+
+    // make_move keeps the search's share of the history free: a full game
+    // history refuses the next move, and searching it still has room
+    Board board;
+    board.reset();
+    const Move shuffle[] = { Move(Square::G1, Square::F3), Move(Square::G8, Square::F6),
+                             Move(Square::F3, Square::G1), Move(Square::F6, Square::G8) };
+    Engine engine;
+    int refused = 0;
+    for (int ply = 0; ply < MAX_GAME_PLIES + 126; ++ply) {
+        try {
+            board.make_move(shuffle[ply % 4]);
+        } catch (const std::length_error&) {
+            assert(ply == MAX_GAME_PLIES);
+            ++refused;
+            [[maybe_unused]] const SearchResult full = engine.find_best_move(board, (Depth)8);
+            assert(board.is_legal_move(full.best_move));
+            board.clear_history();
+            board.make_move(shuffle[ply % 4]);
+        }
+    }
+    assert(refused == 1);
+    [[maybe_unused]] const SearchResult result = engine.find_best_move(board, (Depth)8);
+    assert(board.is_legal_move(result.best_move));
+
+    std::cout << "✓ Games longer than MAX_GAME_PLIES leave the search its room!" << std::endl;
+}
+
+void test_search_copy_make() {
+    std::cout << "\n=== Testing Search - Copy-Make ===" << std::endl;
+
+    Board board;
+    board.load_fen("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+
+    SearchConfig config;
+    Engine unmake(config);
+    config.use_copy_make = true;
+    Engine copy_make(config);
+
+    [[maybe_unused]] const SearchResult a = unmake.find_best_move(board, (Depth)4);
+    [[maybe_unused]] const SearchResult b = copy_make.find_best_move(board, (Depth)4);
+
+    // Same tree either way: only the undo mechanism differs
+    assert(a.best_move == b.best_move && a.score == b.score && a.nodes_searched == b.nodes_searched);
+
+    std::cout << "✓ Copy-make search matches make/unmake!" << std::endl;
+}
+
+void test_search_threads() {
+    std::cout << "\n=== Testing Search - Lazy SMP ===" << std::endl;
+
+    Board board;
+    board.load_fen("rnb1kbnr/pppppppp/8/3q4/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 1");
+
+    SearchConfig config;
+    config.threads = 4;
+    Engine engine(config);
+
+    const SearchResult result = engine.find_best_move(board, (Depth)4);
+    std::cout << "4 threads chose: " << square_to_string(result.best_move.from())
+              << square_to_string(result.best_move.to()) << ", " << result.nodes_searched << " nodes" << std::endl;
+
+    assert(result.depth == 4);
+    assert(result.best_move.from() == Square::E4 && result.best_move.to() == Square::D5);
+    assert(result.nodes_searched > 0);
+
+    std::cout << "✓ Multi-threaded search agrees!" << std::endl;
+}
+
+void test_search_statistics() {
+    std::cout << "\n=== Testing Search - Statistics ===" << std::endl;
+
+    Board board;
+    board.load_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    SearchConfig config;
+    config.tt_size_mb = 1;      // Small enough for the search to fill a visible share
+    std::vector<SearchResult> reports;
+    config.on_iteration_complete = [&reports](const SearchResult& result) { reports.push_back(result); };
+    Engine engine(config);
+
+    const SearchResult result = engine.find_best_move(board, (Depth)6);
+    [[maybe_unused]] const SearchStats& stats = result.stats;
+    std::cout << stats.nodes << " nodes (" << stats.qnodes << " quiescence), TT hit rate " << stats.tt_hit_rate()
+              << ", first-move cutoffs " << stats.first_move_cutoff_rate() << ", seldepth " << stats.seldepth
+              << ", hashfull " << stats.hashfull << std::endl;
+
+    // Each report carries the iterations so far
+    assert(reports.size() == 6 && result.iterations.size() == 6);
+    for (size_t i = 0; i < reports.size(); ++i) {
+        assert(reports[i].iterations.size() == i + 1);
+        assert(reports[i].stats.nodes == reports[i].nodes_searched);
+        assert(result.iterations[i].depth == (Depth)(i + 1));
+        std::cout << "  depth " << i + 1 << ": " << result.iterations[i].nodes << " nodes, EBF "
+                  << result.iterations[i].branching_factor << std::endl;
+    }
+
+    uint64_t iteration_nodes = 0;
+    for (const IterationStats& iteration : result.iterations)
+        iteration_nodes += iteration.nodes;
+    assert(iteration_nodes == stats.nodes && stats.nodes == result.nodes_searched);
+    assert(result.iterations[0].branching_factor == 0 && result.iterations[5].branching_factor > 1);
+
+#ifndef CHESS_NO_SEARCH_STATS
+    assert(stats.qnodes > 0 && stats.qnodes < stats.nodes);
+    assert(stats.tt_cutoffs > 0 && stats.tt_cutoffs <= stats.tt_hits && stats.tt_hits <= stats.tt_probes);
+    assert(stats.tt_collisions <= stats.tt_hits);
+    assert(stats.first_move_cutoffs > 0 && stats.first_move_cutoffs <= stats.cutoffs);
+    assert(stats.seldepth > 6 && stats.seldepth < MAX_PLY);
+    assert(stats.hashfull > 0 && stats.hashfull <= 1000);
+#endif
+
+    std::cout << "✓ Search statistics are consistent!" << std::endl;
+}
+
+void test_search_move_ordering() {
+    std::cout << "\n=== Testing Search - Staged Move Ordering ===" << std::endl;
+
+    Board board;
+    board.load_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    // Ordering changes how much is searched, never the minimax value
+    // (as long as nothing is pruned or reduced on the strength of the order)
+    SearchConfig config;
+    config.use_transposition_table = false;
+    config.use_quiescence_search = false;
+    config.use_pvs = false;
+    config.use_aspiration_windows = false;
+    config.use_null_move_pruning = false;
+    config.use_late_move_reductions = false;
+    config.use_futility_pruning = false;
+    Engine ordered(config);
+    config.use_move_ordering = false;
+    Engine unordered(config);
+
+    const SearchResult a = ordered.find_best_move(board, (Depth)3);
+    const SearchResult b = unordered.find_best_move(board, (Depth)3);
+    std::cout << "Ordered: " << a.nodes_searched << " nodes, unordered: " << b.nodes_searched << " nodes" << std::endl;
+
+    assert(a.score == b.score);
+    assert(a.nodes_searched < b.nodes_searched);
+
+    // Without qsearch pruning, ordered quiescence still searches SEE-losing captures:
+    // ...Qxe4 looks like it loses the queen to Nxe4, but the knight is pinned
+    board.load_fen("4q1k1/8/1b6/8/4P3/8/5N2/6K1 w - - 0 1");
+    config.use_quiescence_search = true;
+    config.use_qsearch_pruning = false;
+    config.use_check_extensions = false;
+    Engine unordered_qsearch(config);
+    config.use_move_ordering = true;
+    Engine ordered_qsearch(config);
+
+    [[maybe_unused]] const SearchResult c = ordered_qsearch.find_best_move(board, (Depth)1);
+    [[maybe_unused]] const SearchResult d = unordered_qsearch.find_best_move(board, (Depth)1);
+    assert(c.score == d.score);
+
+    std::cout << "✓ Staged ordering searches fewer nodes for the same score!" << std::endl;
+}
+
+void test_search_pruning() {
+    std::cout << "\n=== Testing Search - Selective Search ===" << std::endl;
+
+    // Back-rank mate: the pruning suite must not hide it, and the score counts plies to mate
+    Board board;
+    board.load_fen("2r3k1/5ppp/8/8/8/8/5PPP/2RR2K1 w - - 0 1");
+
+    SearchConfig config;
+    Engine selective(config);
+    config.use_pvs = false;
+    config.use_aspiration_windows = false;
+    config.use_null_move_pruning = false;
+    config.use_late_move_reductions = false;
+    config.use_futility_pruning = false;
+    config.use_check_extensions = false;
+    Engine plain(config);
+
+    const SearchResult a = selective.find_best_move(board, (Depth)5);
+    const SearchResult b = plain.find_best_move(board, (Depth)5);
+    std::cout << "Selective: " << a.nodes_searched << " nodes, plain: " << b.nodes_searched << " nodes" << std::endl;
+
+    assert(a.best_move.from() == Square::C1 && a.best_move.to() == Square::C8);
+    assert(a.score == CHECKMATE - 1 && b.score == CHECKMATE - 1);
+    assert(is_mate(a.score) && mate_distance(a.score) == 0);
+
+    // Same depth, fewer nodes in a quiet middlegame
+    board.load_fen("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+    [[maybe_unused]] const SearchResult c = selective.find_best_move(board, (Depth)5);
+    [[maybe_unused]] const SearchResult d = plain.find_best_move(board, (Depth)5);
+    assert(c.nodes_searched < d.nodes_searched);
+
+    std::cout << "✓ Pruned search keeps the mate and searches less!" << std::endl;
+}
+
+void test_time_management() {
+    std::cout << "\n=== Testing Search - Time Management ===" << std::endl;
+
+    // Budgets: an even share plus most of the increment, hard deadline a few times the soft one
+    TimeManager timer;
+    timer.start(TimeControl{ .remaining = 60000ms, .increment = 1000ms });
+    assert(timer.soft_limit() == (60000ms - TimeControl{}.overhead) / 30 + 750ms);
+    assert(timer.hard_limit() > timer.soft_limit() && timer.hard_limit() <= 48000ms);
+
+    timer.start(TimeControl{ .remaining = 1000ms, .moves_to_go = 1 });
+    assert(timer.hard_limit() < 1000ms);
+
+    timer.start(TimeControl{ .remaining = 60000ms, .move_time = 500ms });
+    assert(timer.soft_limit() == timer.hard_limit() && timer.hard_limit() < 500ms);
+
+    // The hard deadline interrupts an iteration instead of waiting for it to finish
+    Board board;
+    board.load_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    SearchConfig config;
+    config.max_depth = MAX_DEPTH;
+    Engine engine(config);
+    const SearchResult result = engine.find_best_move(board, 100ms);
+    std::cout << "100ms search: depth " << (int)result.depth << " in " << result.search_time << "s" << std::endl;
+
+    MoveList legal;
+    board.generate_moves(legal);
+    assert(std::ranges::find(legal, result.best_move) != legal.end());
+    assert(result.search_time < 0.25);
+
+    const SearchResult clocked = engine.find_best_move(board, TimeControl{ .remaining = 2000ms });
+    std::cout << "2s clock: depth " << (int)clocked.depth << " in " << clocked.search_time << "s" << std::endl;
+    assert(std::ranges::find(legal, clocked.best_move) != legal.end());
+    assert(clocked.search_time < 0.5);
+
+    std::cout << "✓ Deadlines hold mid-iteration!" << std::endl;
+}
+
+void test_principal_variation() {
+    std::cout << "\n=== Testing Search - Principal Variation ===" << std::endl;
+
+    Board board;
+    board.load_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    // A tiny table gets overwritten constantly; the collected PV must not care
+    SearchConfig config;
+    config.tt_size_mb = 1;
+    Engine engine(config);
+    const Engine::Analysis analysis = engine.analyze(board, 7);
+
+    std::cout << "PV:";
+    for (const Move m : analysis.pv) std::cout << ' ' << m.to_uci();
+    std::cout << std::endl;
+
+    assert(!analysis.pv.empty() && analysis.pv[0] == analysis.best_move);
+
+    // Every PV move is legal in turn
+    Board line = board;
+    for (const Move m : analysis.pv) {
+        MoveList legal;
+        line.generate_moves(legal);
+        assert(std::ranges::find(legal, m) != legal.end());
+        line.make_move(m);
+    }
+
+    // One score per legal root move, best first
+    MoveList legal;
+    board.generate_moves(legal);
+    assert(analysis.move_scores.size() == legal.size());
+    assert(analysis.move_scores[0].first == analysis.best_move);
+    assert(analysis.move_scores[0].second == analysis.score);
+
+    assert(engine.get_principal_variation(board, 3) ==
+           std::vector<Move>(analysis.pv.begin(), analysis.pv.begin() + std::min<size_t>(3, analysis.pv.size())));
+
+    std::cout << "✓ PV is legal and root moves are all scored!" << std::endl;
+}
+
 int main() {
     try {
         std::cout << "╔════════════════════════════════════════╗" << std::endl;
         std::cout << "║      Phase 2: Search & Evaluation      ║" << std::endl;
         std::cout << "╚════════════════════════════════════════╝" << std::endl;
         
+        test_incremental_evaluation();
+        test_pawn_structure();
+        test_nnue_evaluation();
         test_evaluator();
+        test_transposition_table();
         test_search_starting_position();
         test_search_capture_preference();
         test_search_checkmate_avoidance();
         test_search_depth();
+        test_search_long_game();
+        test_search_copy_make();
+        test_search_threads();
+        test_search_statistics();
+        test_search_move_ordering();
+        test_search_pruning();
+        test_time_management();
+        test_principal_variation();
+        test_opening_book();
+        test_tablebase();
+        test_batch_analysis();
+        test_engine_pool();
         
         std::cout << "\n╔════════════════════════════════════════╗" << std::endl;
         std::cout << "║          ✓ ALL TESTS PASSED            ║" << std::endl;
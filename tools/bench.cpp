@@ -0,0 +1,257 @@
+// chess-bench: microbenchmarks and the search node-count signature.
+//
+//   chess-bench [--benchmark_filter=...]          microbenchmarks (Google Benchmark options)
+//   chess-bench bench [depth] [hash MB]           fixed-depth search over the suite
+//
+// `bench` prints the total node count, a signature of the search: it changes
+// exactly when a change alters what the search does, and is the same on every
+// machine and build type. It also reports NPS, the end-to-end speed figure.
+// One thread, a fresh table per position, the piece-square evaluation.
+
+#include "chess/Board.hpp"
+#include "chess/Eval.hpp"
+#include "chess/Search.hpp"
+#include "chess/TranspositionTable.hpp"
+#include "chess/ZobristHasher.hpp"
+#include "chess/internal/Bitboard.hpp"
+
+#ifdef CHESS_HAVE_GOOGLE_BENCHMARK
+#include <benchmark/benchmark.h>
+#endif
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace chess;
+
+namespace {
+
+// Openings, middlegames with both castlings and promotions, and endgames
+constexpr const char* SUITE[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "r1bqkb1r/pp3ppp/2n1pn2/2pp4/3P4/2PBPN2/PP1N1PPP/R1BQK2R b KQkq - 1 6",
+    "2r2rk1/pp1bqppp/2n1pn2/3p4/2PP4/P1NBPN2/1P3PPP/R2Q1RK1 b - - 0 13",
+    "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1",
+    "8/8/1p1k4/1P6/2K5/8/8/8 w - - 0 1",
+    "4r1k1/1b3ppp/p7/1p1Pq3/1P2n3/P3BN1P/5PP1/2RQ2K1 b - - 2 27",
+    "8/5pk1/6p1/1p1Q4/1P6/6P1/r4PKP/8 b - - 3 41",
+};
+
+constexpr int DEFAULT_DEPTH = 10;
+constexpr int DEFAULT_HASH_MB = 16;
+
+std::vector<Board> suite_boards() {
+    std::vector<Board> boards(std::size(SUITE));
+    for (size_t i = 0; i < boards.size(); ++i)
+        boards[i].load_fen(SUITE[i]);
+    return boards;
+}
+
+int run_bench(const int depth, const int hash_mb) {
+    SearchConfig config;
+    config.tt_size_mb = hash_mb;
+    config.max_depth = depth;
+    const Engine engine(config);
+
+    uint64_t total_nodes = 0;
+    double total_seconds = 0;
+    for (size_t i = 0; i < std::size(SUITE); ++i) {
+        Board board;
+        board.load_fen(SUITE[i]);
+        engine.clear_cache();
+
+        const SearchResult result = engine.find_best_move(board, (Depth)depth);
+        total_nodes += result.nodes_searched;
+        total_seconds += result.search_time;
+        std::cout << "Position " << std::setw(2) << i + 1 << "/" << std::size(SUITE)
+                  << std::setw(8) << result.best_move.to_uci()
+                  << std::setw(12) << result.nodes_searched << " nodes" << std::endl;
+    }
+
+    std::cout << "===========================\n"
+              << "Total time (ms) : " << (uint64_t)(total_seconds * 1000) << "\n"
+              << "Nodes searched  : " << total_nodes << "\n"
+              << "Nodes/second    : " << (uint64_t)((double)total_nodes / std::max(total_seconds, 1e-9)) << std::endl;
+    return EXIT_SUCCESS;
+}
+
+#ifdef CHESS_HAVE_GOOGLE_BENCHMARK
+
+// ============================================================================
+// Microbenchmarks: each iteration covers the whole suite
+// ============================================================================
+
+void BM_RookAttacks(benchmark::State& state) {
+    internal::init_attacks();
+    const std::vector<Board> boards = suite_boards();
+    for (auto _ : state) {
+        for (const Board& board : boards) {
+            const Bitboard occupancy = board.position().occupancy_all;
+            for (int sq = 0; sq < 64; ++sq)
+                benchmark::DoNotOptimize(internal::rook_attacks((Square)sq, occupancy));
+        }
+    }
+    state.SetItemsProcessed((int64_t)(state.iterations() * boards.size() * 64));
+}
+BENCHMARK(BM_RookAttacks);
+
+void BM_BishopAttacks(benchmark::State& state) {
+    internal::init_attacks();
+    const std::vector<Board> boards = suite_boards();
+    for (auto _ : state) {
+        for (const Board& board : boards) {
+            const Bitboard occupancy = board.position().occupancy_all;
+            for (int sq = 0; sq < 64; ++sq)
+                benchmark::DoNotOptimize(internal::bishop_attacks((Square)sq, occupancy));
+        }
+    }
+    state.SetItemsProcessed((int64_t)(state.iterations() * boards.size() * 64));
+}
+BENCHMARK(BM_BishopAttacks);
+
+void BM_GenerateMoves(benchmark::State& state) {
+    const std::vector<Board> boards = suite_boards();
+    MoveList moves;
+    for (auto _ : state) {
+        for (const Board& board : boards) {
+            moves.clear();
+            board.generate_moves(moves);
+            benchmark::DoNotOptimize(moves.size());
+        }
+    }
+    state.SetItemsProcessed((int64_t)(state.iterations() * boards.size()));
+}
+BENCHMARK(BM_GenerateMoves);
+
+void BM_GenerateCaptures(benchmark::State& state) {
+    const std::vector<Board> boards = suite_boards();
+    MoveList moves;
+    for (auto _ : state) {
+        for (const Board& board : boards) {
+            moves.clear();
+            board.generate_captures(moves);
+            benchmark::DoNotOptimize(moves.size());
+        }
+    }
+    state.SetItemsProcessed((int64_t)(state.iterations() * boards.size()));
+}
+BENCHMARK(BM_GenerateCaptures);
+
+/// Every legal move of every suite position, made and unmade: unchecked (the
+/// search's path) for state.range(0) == 0, through the validating API otherwise
+void BM_MakeUndo(benchmark::State& state) {
+    const std::vector<Board> boards = suite_boards();
+    std::vector<MoveList> moves(boards.size());
+    size_t count = 0;
+    for (size_t i = 0; i < boards.size(); ++i) {
+        boards[i].generate_moves(moves[i]);
+        count += moves[i].size();
+    }
+
+    const bool checked = state.range(0) != 0;
+    for (auto _ : state) {
+        for (size_t i = 0; i < boards.size(); ++i) {
+            for (const Move move : moves[i]) {
+                if (checked) {
+                    boards[i].make_move(move);
+                    boards[i].undo_move();
+                } else {
+                    boards[i].make_move_unchecked(move);
+                    boards[i].undo_move_unchecked();
+                }
+            }
+            benchmark::DoNotOptimize(boards[i].zobrist_hash());
+        }
+    }
+    state.SetItemsProcessed((int64_t)(state.iterations() * count));
+}
+BENCHMARK(BM_MakeUndo)->ArgName("checked")->Arg(0)->Arg(1);
+
+void BM_Evaluate(benchmark::State& state) {
+    const std::vector<Board> boards = suite_boards();
+    const Evaluator evaluator;
+    for (auto _ : state) {
+        for (const Board& board : boards)
+            benchmark::DoNotOptimize(evaluator.evaluate(board));
+    }
+    state.SetItemsProcessed((int64_t)(state.iterations() * boards.size()));
+}
+BENCHMARK(BM_Evaluate);
+
+/// Full recomputation; make/unmake keep the key up to date incrementally
+void BM_ZobristHash(benchmark::State& state) {
+    const std::vector<Board> boards = suite_boards();
+    for (auto _ : state) {
+        for (const Board& board : boards)
+            benchmark::DoNotOptimize(ZobristHasher::compute(board.position()));
+    }
+    state.SetItemsProcessed((int64_t)(state.iterations() * boards.size()));
+}
+BENCHMARK(BM_ZobristHash);
+
+/// Store then look up the legal successors of every suite position, in a
+/// table of state.range(0) MB: small ones stay in cache, large ones miss it
+void BM_TranspositionTable(benchmark::State& state) {
+    const std::vector<Board> boards = suite_boards();
+    std::vector<std::pair<Hash, Move>> keys;
+    for (const Board& board : boards) {
+        MoveList moves;
+        board.generate_moves(moves);
+        for (const Move move : moves) {
+            board.make_move_unchecked(move);
+            keys.emplace_back(board.zobrist_hash(), move);
+            board.undo_move_unchecked();
+        }
+    }
+
+    TranspositionTable table((size_t)state.range(0));
+    uint64_t salt = 0;
+    for (auto _ : state) {
+        // A new salt each pass, so stores keep finding fresh slots to replace
+        salt += 0x9E3779B97F4A7C15ULL;
+        for (const auto& [hash, move] : keys)
+            table.store(hash ^ salt, 0, 5, EXACT, move);
+        for (const auto& [hash, move] : keys)
+            benchmark::DoNotOptimize(table.lookup(hash ^ salt, 0));
+    }
+    state.SetItemsProcessed((int64_t)(state.iterations() * keys.size() * 2));
+}
+BENCHMARK(BM_TranspositionTable)->ArgName("mb")->Arg(1)->Arg(256);
+
+#endif  // CHESS_HAVE_GOOGLE_BENCHMARK
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc >= 2 && !std::strcmp(argv[1], "bench")) {
+        const int depth = argc >= 3 ? std::atoi(argv[2]) : DEFAULT_DEPTH;
+        const int hash_mb = argc >= 4 ? std::atoi(argv[3]) : DEFAULT_HASH_MB;
+        if (depth < 1 || depth > MAX_DEPTH || hash_mb < 1) {
+            std::cerr << "usage: chess-bench bench [depth 1-" << MAX_DEPTH << "] [hash MB]" << std::endl;
+            return EXIT_FAILURE;
+        }
+        return run_bench(depth, hash_mb);
+    }
+
+#ifdef CHESS_HAVE_GOOGLE_BENCHMARK
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return EXIT_FAILURE;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return EXIT_SUCCESS;
+#else
+    std::cerr << "chess-bench was built without Google Benchmark; only `chess-bench bench` is available" << std::endl;
+    return EXIT_FAILURE;
+#endif
+}
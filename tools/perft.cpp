@@ -0,0 +1,139 @@
+// chess-perft: move generator regression gate and throughput benchmark.
+//
+//   chess-perft [--quick] [--threads N] [--hash MB]      run the standard suite
+//   chess-perft --fen "<FEN>" --depth D [--divide] ...   count a single position
+//
+// The suite exits non-zero if any count differs from the published value.
+
+#include "chess/Board.hpp"
+#include "chess/Perft.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace chess;
+
+namespace {
+
+struct PerftCase {
+    const char* name;
+    const char* fen;
+    int depth;
+    uint64_t nodes;
+};
+
+// Reference counts from the Chess Programming Wiki perft results page
+constexpr PerftCase SUITE[] = {
+    {"startpos", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5, 4865609},
+    {"kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4, 4085603},
+    {"position3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 6, 11030083},
+    {"position4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 5, 15833292},
+    {"position5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 2103487},
+    {"position6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4, 3894594},
+};
+
+// Same positions one ply shallower, for the ctest gate
+constexpr uint64_t QUICK_NODES[] = {197281, 97862, 674624, 422333, 62379, 89890};
+
+double seconds_since(const std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void print_row(const std::string& name, const int depth, const uint64_t nodes, const double seconds) {
+    std::cout << std::left << std::setw(12) << name << std::right
+              << std::setw(4) << (depth > 0 ? std::to_string(depth) : "")
+              << std::setw(14) << nodes
+              << std::setw(10) << std::fixed << std::setprecision(3) << seconds << "s"
+              << std::setw(14) << (uint64_t)(nodes / std::max(seconds, 1e-9)) << " nps";
+}
+
+int run_suite(const bool quick, const PerftConfig& config) {
+    bool all_ok = true;
+    uint64_t total_nodes = 0;
+    double total_seconds = 0;
+
+    for (size_t i = 0; i < std::size(SUITE); ++i) {
+        const PerftCase& test = SUITE[i];
+        const int depth = quick ? test.depth - 1 : test.depth;
+        const uint64_t expected = quick ? QUICK_NODES[i] : test.nodes;
+
+        Board board;
+        board.load_fen(test.fen);
+
+        const auto start = std::chrono::steady_clock::now();
+        const uint64_t nodes = perft(board, depth, config);
+        const double seconds = seconds_since(start);
+
+        total_nodes += nodes;
+        total_seconds += seconds;
+
+        print_row(test.name, depth, nodes, seconds);
+        if (nodes == expected) {
+            std::cout << "  OK" << std::endl;
+        } else {
+            std::cout << "  FAIL (expected " << expected << ")" << std::endl;
+            all_ok = false;
+        }
+    }
+
+    print_row("total", 0, total_nodes, total_seconds);
+    std::cout << std::endl;
+
+    return all_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+}  // namespace
+
+int main(const int argc, char** argv) {
+    PerftConfig config;
+    std::string fen;
+    int depth = 0;
+    bool quick = false;
+    bool show_divide = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--quick")) quick = true;
+        else if (!std::strcmp(argv[i], "--divide")) show_divide = true;
+        else if (!std::strcmp(argv[i], "--threads") && has_value) config.threads = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--hash") && has_value) config.hash_mb = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--fen") && has_value) fen = argv[++i];
+        else if (!std::strcmp(argv[i], "--depth") && has_value) depth = std::atoi(argv[++i]);
+        else {
+            std::cerr << "usage: chess-perft [--quick] [--threads N] [--hash MB]\n"
+                      << "       chess-perft --fen \"<FEN>\" --depth D [--divide] [--threads N] [--hash MB]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    try {
+        if (fen.empty())
+            return run_suite(quick, config);
+
+        Board board;
+        board.load_fen(fen);
+
+        const auto start = std::chrono::steady_clock::now();
+        uint64_t nodes = 0;
+        if (show_divide) {
+            for (const auto& [move, count] : divide(board, depth, config)) {
+                std::cout << move.to_uci() << ": " << count << std::endl;
+                nodes += count;
+            }
+        } else {
+            nodes = perft(board, depth, config);
+        }
+
+        print_row("position", depth, nodes, seconds_since(start));
+        std::cout << std::endl;
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
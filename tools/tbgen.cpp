@@ -0,0 +1,35 @@
+// chess-tbgen: writes the three-piece endgame tablebases.
+//
+//   chess-tbgen <directory>
+//
+// Solves KQvK, KRvK and KPvK by retrograde analysis and writes one file per
+// ending into the directory, ready for Tablebase::open or the UCI
+// TablebasePath option.
+
+#include "chess/Tablebase.hpp"
+
+#include <chrono>
+#include <exception>
+#include <iostream>
+
+using namespace chess;
+
+int main(const int argc, char** argv) {
+    if (argc != 2) {
+        std::cerr << "usage: chess-tbgen <directory>\n";
+        return 2;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    try {
+        Tablebase::generate(argv[1]);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "chess-tbgen: " << e.what() << "\n";
+        return 1;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "tablebases written to " << argv[1] << " in " << seconds << "s\n";
+    return 0;
+}
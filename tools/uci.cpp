@@ -0,0 +1,411 @@
+// chess-uci: Universal Chess Interface frontend.
+//
+//   chess-uci            speak UCI on stdin/stdout (for GUIs and match runners)
+//
+// Searches run on a background thread, so stop, ponderhit and isready are
+// answered while the engine is thinking.
+
+#include "chess/Board.hpp"
+#include "chess/Nnue.hpp"
+#include "chess/OpeningBook.hpp"
+#include "chess/Tablebase.hpp"
+#include "chess/Search.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace chess;
+
+namespace {
+
+constexpr const char* START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+constexpr int DEFAULT_HASH_MB = 64;
+constexpr int MAX_HASH_MB = 65536;
+constexpr int MAX_THREADS = 256;
+constexpr int DEFAULT_OVERHEAD_MS = 20;
+
+std::mutex output_mutex;
+
+/// One whole line to stdout; the search thread and the input loop both write
+void send(const std::string& line) {
+    const std::lock_guard lock(output_mutex);
+    std::cout << line << std::endl;
+}
+
+/// "cp N" or "mate N" (moves, negative when we are the one being mated)
+std::string format_score(const Score score) {
+    if (!is_mate(score))
+        return "cp " + std::to_string(score);
+
+    const int moves = (CHECKMATE - std::abs(score) + 1) / 2;
+    return "mate " + std::to_string(score > 0 ? moves : -moves);
+}
+
+/// The legal move a UCI string names, or Move() if there is none.
+/// Move::from_uci can't know capture/castling/en passant flags; the generator does.
+Move parse_move(const Board& board, const std::string& text) {
+    const Move wanted = Move::from_uci(text);
+
+    MoveList legal;
+    board.generate_moves(legal);
+    for (const Move m : legal) {
+        if (m.from() == wanted.from() && m.to() == wanted.to() &&
+            m.is_promotion() == wanted.is_promotion() &&
+            (!m.is_promotion() || m.promotion() == wanted.promotion()))
+            return m;
+    }
+    return {};
+}
+
+class UciSession {
+public:
+    UciSession() {
+        SearchConfig config = engine.get_config();
+        config.max_depth = MAX_DEPTH;
+        engine.set_config(config);
+        engine.set_tt_size(DEFAULT_HASH_MB);
+        board.load_fen(START_FEN);
+    }
+
+    ~UciSession() { stop_search(); }
+
+    void run(std::istream& in) {
+        std::string line;
+        while (std::getline(in, line)) {
+            std::istringstream args(line);
+            std::string command;
+            args >> command;
+
+            if (command == "uci") handle_uci();
+            else if (command == "isready") send("readyok");
+            else if (command == "setoption") handle_setoption(args);
+            else if (command == "ucinewgame") handle_new_game();
+            else if (command == "position") handle_position(args);
+            else if (command == "go") handle_go(args);
+            else if (command == "stop") stop_search();
+            else if (command == "ponderhit") handle_ponderhit();
+            else if (command == "d") send(board.to_string() + "\nFen: " + board.to_fen());
+            else if (command == "quit") break;
+            else if (!command.empty()) send("info string unknown command: " + command);
+        }
+        stop_search();
+    }
+
+private:
+    Engine engine;
+    Board board;
+    int move_overhead_ms = DEFAULT_OVERHEAD_MS;
+    std::shared_ptr<const OpeningBook> book;
+    bool own_book = false;
+
+    // Last `position` command, so a game that grew by a move or two replays only those
+    std::string position_base;
+    std::vector<std::string> position_moves;
+
+    std::thread search_thread;
+    std::mutex search_mutex;
+    std::condition_variable search_cv;
+    bool hold_bestmove = false;     // go ponder / go infinite: bestmove waits for ponderhit or stop
+    bool infinite = false;
+
+    // Requests that may arrive before the search has reset its own state; the
+    // iteration callback re-applies them
+    std::atomic<bool> stop_pending = false;
+    std::atomic<bool> ponderhit_pending = false;
+
+    void handle_uci() const {
+        const SearchConfig config = engine.get_config();
+        send("id name chess-engine");
+        send("id author chess-engine authors");
+        send("option name Hash type spin default " + std::to_string(DEFAULT_HASH_MB) +
+             " min 1 max " + std::to_string(MAX_HASH_MB));
+        send("option name Threads type spin default " + std::to_string(config.threads) +
+             " min 1 max " + std::to_string(MAX_THREADS));
+        send("option name Move Overhead type spin default " + std::to_string(DEFAULT_OVERHEAD_MS) +
+             " min 0 max 5000");
+        send("option name Ponder type check default false");
+        send("option name EvalFile type string default <empty>");
+        send("option name OwnBook type check default false");
+        send("option name BookFile type string default <empty>");
+        send("option name TablebasePath type string default <empty>");
+        send("option name TablebaseProbeDepth type spin default " + std::to_string(config.tablebase_probe_depth) +
+             " min 1 max " + std::to_string(MAX_DEPTH));
+        send("uciok");
+    }
+
+    void handle_setoption(std::istringstream& args) {
+        // setoption name <id, may contain spaces> [value <x>]
+        std::string token, name, value;
+        args >> token;
+        while (args >> token && token != "value") {
+            if (!name.empty()) name += ' ';
+            name += token;
+        }
+        std::getline(args >> std::ws, value);
+
+        wait_for_search();
+        try {
+            if (name == "Hash") {
+                engine.set_tt_size(std::clamp(std::stoi(value), 1, MAX_HASH_MB));
+            } else if (name == "Threads") {
+                SearchConfig config = engine.get_config();
+                config.threads = std::clamp(std::stoi(value), 1, MAX_THREADS);
+                engine.set_config(config);
+            } else if (name == "Move Overhead") {
+                move_overhead_ms = std::clamp(std::stoi(value), 0, 5000);
+            } else if (name == "EvalFile") {
+                // No network means the piece-square evaluation
+                const bool none = value.empty() || value == "<empty>";
+                engine.set_network(none ? nullptr : NnueNetwork::load(value));
+                if (!none) send("info string NNUE network loaded from " + value);
+            } else if (name == "OwnBook") {
+                own_book = value == "true";
+                update_book();
+            } else if (name == "BookFile") {
+                const bool none = value.empty() || value == "<empty>";
+                book = none ? nullptr : OpeningBook::open(value);
+                update_book();
+                if (!none) send("info string book " + value + ": " + std::to_string(book->size()) + " entries");
+            } else if (name == "TablebasePath") {
+                // Directory of chess-tbgen output; tables missing from it just aren't probed
+                const bool none = value.empty() || value == "<empty>";
+                SearchConfig config = engine.get_config();
+                config.tablebase = none ? nullptr : Tablebase::open(value);
+                engine.set_config(config);
+                if (!none) send("info string tablebases up to " + std::to_string(config.tablebase->cardinality()) +
+                                " pieces from " + value);
+            } else if (name == "TablebaseProbeDepth") {
+                SearchConfig config = engine.get_config();
+                config.tablebase_probe_depth = std::clamp(std::stoi(value), 1, MAX_DEPTH);
+                engine.set_config(config);
+            } else if (name != "Ponder") {
+                send("info string unknown option: " + name);
+            }
+        }
+        catch (const std::exception& e) {
+            send("info string bad value for " + name + ": " + value + " (" + e.what() + ")");
+        }
+    }
+
+    void update_book() {
+        SearchConfig config = engine.get_config();
+        config.book = own_book ? book : nullptr;
+        engine.set_config(config);
+    }
+
+    void handle_new_game() {
+        wait_for_search();
+        engine.clear_cache();
+        position_base.clear();
+        position_moves.clear();
+        board.load_fen(START_FEN);
+    }
+
+    void handle_position(std::istringstream& args) {
+        std::string token, base;
+        args >> token;
+        if (token == "startpos") {
+            base = START_FEN;
+            args >> token;
+        } else if (token == "fen") {
+            while (args >> token && token != "moves") {
+                if (!base.empty()) base += ' ';
+                base += token;
+            }
+        } else {
+            return;
+        }
+
+        std::vector<std::string> moves;
+        while (args >> token)
+            moves.push_back(token);
+
+        wait_for_search();
+
+        // Same game, more moves: play only the new ones on the board we already have
+        size_t first_new = 0;
+        if (base == position_base && moves.size() >= position_moves.size() &&
+            std::equal(position_moves.begin(), position_moves.end(), moves.begin())) {
+            first_new = position_moves.size();
+        } else {
+            try {
+                board.load_fen(base);
+            }
+            catch (const std::exception& e) {
+                send(std::string("info string bad fen: ") + e.what());
+                position_base.clear();
+                position_moves.clear();
+                return;
+            }
+        }
+
+        // The board keeps MAX_GAME_PLIES of history, leaving the rest for the search;
+        // a longer game drops it as PgnReader::replay does, which only loses
+        // repetitions across the cut
+        size_t history = board.move_history().size();
+        for (size_t i = first_new; i < moves.size(); ++i) {
+            const Move move = parse_move(board, moves[i]);
+            if (move == Move()) {
+                send("info string illegal move: " + moves[i]);
+                moves.resize(i);
+                break;
+            }
+            if (history == MAX_GAME_PLIES) {
+                board.clear_history();
+                history = 0;
+            }
+            board.make_move(move);
+            ++history;
+        }
+
+        position_base = base;
+        position_moves = std::move(moves);
+    }
+
+    void handle_go(std::istringstream& args) {
+        wait_for_search();
+
+        const Color us = board.side_to_move();
+        TimeControl clock;
+        clock.overhead = std::chrono::milliseconds(move_overhead_ms);
+        int depth = 0;
+        uint64_t nodes = 0;
+        bool timed = false;
+        infinite = false;
+
+        std::string token;
+        while (args >> token) {
+            const auto read_ms = [&args] {
+                long long ms = 0;
+                args >> ms;
+                return std::chrono::milliseconds(std::max(ms, 0LL));
+            };
+
+            if (token == "wtime") { const auto t = read_ms(); if (us == Color::WHITE) clock.remaining = t; timed = true; }
+            else if (token == "btime") { const auto t = read_ms(); if (us == Color::BLACK) clock.remaining = t; timed = true; }
+            else if (token == "winc") { const auto t = read_ms(); if (us == Color::WHITE) clock.increment = t; }
+            else if (token == "binc") { const auto t = read_ms(); if (us == Color::BLACK) clock.increment = t; }
+            else if (token == "movestogo") args >> clock.moves_to_go;
+            else if (token == "movetime") { clock.move_time = read_ms(); timed = true; }
+            else if (token == "depth") args >> depth;
+            else if (token == "nodes") args >> nodes;
+            else if (token == "infinite") infinite = true;
+            else if (token == "ponder") clock.ponder = true;
+        }
+
+        // Without a clock, a depth or a node limit there is nothing to stop on but `stop`
+        if (!timed && depth <= 0 && nodes == 0)
+            infinite = true;
+
+        stop_pending = false;
+        ponderhit_pending = false;
+        hold_bestmove = infinite || clock.ponder;
+
+        SearchConfig config = engine.get_config();
+        config.max_depth = depth > 0 ? std::min(depth, MAX_DEPTH) : MAX_DEPTH;
+        config.node_limit = nodes;
+        config.on_iteration_complete = [this](const SearchResult& result) {
+            if (stop_pending) engine.stop_search();
+            if (ponderhit_pending) engine.ponder_hit();
+            report_iteration(result);
+        };
+        engine.set_config(config);
+
+        search_thread = std::thread([this, root = board, clock, timed, max_depth = config.max_depth] {
+            const SearchResult result = timed ? engine.find_best_move(root, clock)
+                                              : engine.find_best_move(root, (Depth)max_depth);
+
+            // UCI: no bestmove while pondering or in infinite mode until told to stop
+            {
+                std::unique_lock lock(search_mutex);
+                search_cv.wait(lock, [this] { return !hold_bestmove; });
+            }
+
+            std::ostringstream line;
+            line << "bestmove " << result.best_move.to_uci();
+            if (result.pv.size() >= 2 && result.pv[0] == result.best_move)
+                line << " ponder " << result.pv[1].to_uci();
+            send(line.str());
+        });
+    }
+
+    static void report_iteration(const SearchResult& result) {
+        const auto ms = (uint64_t)(result.search_time * 1000);
+        const auto nps = (uint64_t)((double)result.nodes_searched / std::max(result.search_time, 1e-3));
+
+        std::ostringstream line;
+        line << "info depth " << (int)result.depth;
+        if (result.stats.seldepth > 0)
+            line << " seldepth " << result.stats.seldepth;
+        line << " score " << format_score(result.score)
+             << " nodes " << result.nodes_searched << " nps " << nps << " hashfull " << result.stats.hashfull
+             << " time " << ms << " pv";
+
+        if (result.pv.empty())
+            line << ' ' << result.best_move.to_uci();
+        for (const Move m : result.pv)
+            line << ' ' << m.to_uci();
+
+        send(line.str());
+    }
+
+    void handle_ponderhit() {
+        ponderhit_pending = true;
+        engine.ponder_hit();
+        release_bestmove(infinite);
+    }
+
+    void stop_search() {
+        stop_pending = true;
+        engine.stop_search();
+        release_bestmove(false);
+        if (search_thread.joinable())
+            search_thread.join();
+    }
+
+    void wait_for_search() {
+        if (!search_thread.joinable()) return;
+
+        // Commands that change engine state let a timed or depth search finish;
+        // a held one (ponder, infinite) would only end on stop
+        bool held;
+        {
+            const std::lock_guard lock(search_mutex);
+            held = hold_bestmove;
+        }
+        if (held) stop_search();
+        else search_thread.join();
+    }
+
+    void release_bestmove(const bool keep_holding) {
+        {
+            const std::lock_guard lock(search_mutex);
+            hold_bestmove = keep_holding;
+        }
+        search_cv.notify_all();
+    }
+};
+
+}  // namespace
+
+int main() {
+    std::ios::sync_with_stdio(false);
+
+    try {
+        UciSession session;
+        session.run(std::cin);
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}